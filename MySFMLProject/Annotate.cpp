@@ -0,0 +1,392 @@
+// Batch PGN annotator.
+//
+// Three stages joined by bounded queues:
+//   reader   parses games from the input and queues them
+//   workers  search every position of a game in order with a fixed node budget
+//            (one Search per thread)
+//   writer   prints finished games in input order with evaluations and ?/?? marks
+// The reader also stops when too many games are in flight, so a slow writer or
+// a huge input never makes memory grow without bound.
+//
+// A game stays on one worker, which clears its table once at the start of the
+// game and then keeps it, so each search reuses what the previous ply found.
+// The output therefore does not depend on the number of threads or on
+// scheduling. Parallelism is across games, so a single long game runs on one thread.
+//
+// Usage: annotate games.pgn [--out annotated.pgn] [--threads N] [--nodes 20000] [--hash 4]
+
+#include "BoundedQueue.h"
+#include "MoveGen.h"
+#include "Search.h"
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Centipawn losses that earn a "?" or "??"
+const int MISTAKE_LOSS = 100;
+const int BLUNDER_LOSS = 300;
+
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::string startFen;
+    std::vector<Move> moves;
+    std::string result = "*";
+};
+
+// Streams games out of a PGN file one at a time, keeping only the main line
+class PgnReader {
+public:
+    explicit PgnReader(std::istream& input) : in(input) {}
+
+    bool next(PgnGame& game) {
+        game = PgnGame();
+        std::string line, movetext;
+        bool sawTags = false;
+
+        while (nextLine(line)) {
+            if (line.empty()) {
+                if (!movetext.empty())
+                    break;
+                continue;
+            }
+            if (line[0] == '[') {
+                if (!movetext.empty()) {
+                    pending = line;   // the next game's tags end this one's movetext
+                    hasPending = true;
+                    break;
+                }
+                sawTags = true;
+                parseTag(line, game);
+            } else if (line[0] != '%') {
+                movetext += line;
+                movetext += '\n';
+            }
+        }
+        if (!sawTags && movetext.empty())
+            return false;
+        parseMovetext(movetext, game);
+        return true;
+    }
+
+private:
+    std::istream& in;
+    std::string pending;
+    bool hasPending = false;
+
+    bool nextLine(std::string& line) {
+        if (hasPending) {
+            line = pending;
+            hasPending = false;
+            return true;
+        }
+        if (!std::getline(in, line))
+            return false;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        return true;
+    }
+
+    static void parseTag(const std::string& line, PgnGame& game) {
+        size_t space = line.find(' ');
+        size_t open = line.find('"'), close = line.rfind('"');
+        if (space == std::string::npos || open == std::string::npos || close <= open)
+            return;
+        std::string name = line.substr(1, space - 1);
+        std::string value = line.substr(open + 1, close - open - 1);
+        game.tags.emplace_back(name, value);
+        if (name == "FEN")
+            game.startFen = value;
+        else if (name == "Result")
+            game.result = value;
+    }
+
+    static void parseMovetext(const std::string& text, PgnGame& game) {
+        Position pos;
+        if (game.startFen.empty() || !pos.setFromFEN(game.startFen))
+            pos.setStartPosition();
+
+        int variationDepth = 0;
+        bool illegal = false;
+        size_t i = 0;
+        while (i < text.size()) {
+            char ch = text[i];
+            if (std::isspace((unsigned char)ch)) {
+                ++i;
+            } else if (ch == '{') {
+                size_t end = text.find('}', i);
+                i = end == std::string::npos ? text.size() : end + 1;
+            } else if (ch == ';') {
+                size_t end = text.find('\n', i);
+                i = end == std::string::npos ? text.size() : end + 1;
+            } else if (ch == '(') {
+                ++variationDepth;
+                ++i;
+            } else if (ch == ')') {
+                --variationDepth;
+                ++i;
+            } else {
+                size_t end = i;
+                while (end < text.size() && !std::isspace((unsigned char)text[end]) &&
+                       std::string("{}();").find(text[end]) == std::string::npos)
+                    ++end;
+                std::string token = text.substr(i, end - i);
+                i = end;
+
+                if (variationDepth > 0 || illegal || token[0] == '$')
+                    continue;
+                if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+                    game.result = token;
+                    continue;
+                }
+                // Strip a leading move number such as "12." or "12..."
+                size_t start = 0;
+                while (start < token.size() && (std::isdigit((unsigned char)token[start]) || token[start] == '.'))
+                    ++start;
+                if (start > 0 && token[start - 1] != '.')
+                    start = 0;
+                token = token.substr(start);
+                if (token.empty())
+                    continue;
+
+                Move m = parseSan(pos, token);
+                if (m == NULL_MOVE) {
+                    // Keep the moves up to here rather than dropping the game
+                    std::cerr << "Illegal move " << token << " after " << game.moves.size() << " plies" << std::endl;
+                    illegal = true;
+                    continue;
+                }
+                UndoInfo undo;
+                pos.makeMove(m, undo);
+                game.moves.push_back(m);
+            }
+        }
+    }
+};
+
+struct GameRecord {
+    size_t index = 0;
+    PgnGame game;
+    std::vector<int> scores;        // side to move's score before ply i (one extra for the final position)
+    std::vector<Move> bestMoves;    // the engine's choice before ply i
+};
+
+// Mate scores are capped so a missed mate counts as a big loss, not an overflow
+int clampScore(int score) {
+    if (score > 2000) return 2000;
+    if (score < -2000) return -2000;
+    return score;
+}
+
+std::string formatScore(int whiteScore) {
+    char buffer[32];
+    if (isMateScore(whiteScore)) {
+        int plies = MATE_SCORE - (whiteScore > 0 ? whiteScore : -whiteScore);
+        std::snprintf(buffer, sizeof(buffer), "#%s%d", whiteScore > 0 ? "" : "-", (plies + 1) / 2);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%+.2f", whiteScore / 100.0);
+    }
+    return buffer;
+}
+
+// Appends tokens to the movetext, wrapping lines at 79 columns
+class MovetextWriter {
+public:
+    explicit MovetextWriter(std::ostream& output) : out(output) {}
+
+    void add(const std::string& token) {
+        if (column > 0 && column + 1 + token.size() > 79) {
+            out << '\n';
+            column = 0;
+        } else if (column > 0) {
+            out << ' ';
+            ++column;
+        }
+        out << token;
+        column += token.size();
+    }
+
+    void finish() {
+        out << "\n\n";
+        column = 0;
+    }
+
+private:
+    std::ostream& out;
+    size_t column = 0;
+};
+
+void writeGame(std::ostream& out, const GameRecord& record) {
+    const PgnGame& game = record.game;
+    for (const auto& tag : game.tags)
+        out << '[' << tag.first << " \"" << tag.second << "\"]\n";
+    out << "[Annotator \"MySFMLProject\"]\n\n";
+
+    Position pos;
+    if (game.startFen.empty() || !pos.setFromFEN(game.startFen))
+        pos.setStartPosition();
+
+    MovetextWriter text(out);
+    bool needNumber = true;   // set after a comment, which splits a move pair
+    for (size_t ply = 0; ply < game.moves.size(); ++ply) {
+        Move m = game.moves[ply];
+        bool white = pos.sideToMove() == WHITE;
+        if (white)
+            text.add(std::to_string(pos.fullmoveNumber()) + ".");
+        else if (needNumber)
+            text.add(std::to_string(pos.fullmoveNumber()) + "...");
+
+        // Both scores from the mover's point of view
+        int before = clampScore(record.scores[ply]);
+        int after = clampScore(-record.scores[ply + 1]);
+        int loss = before - after;
+        std::string san = moveToSan(pos, m);
+        std::string best = record.bestMoves[ply] != NULL_MOVE && record.bestMoves[ply] != m
+                               ? moveToSan(pos, record.bestMoves[ply]) : std::string();
+        if (loss >= BLUNDER_LOSS && !best.empty())
+            san += "??";
+        else if (loss >= MISTAKE_LOSS && !best.empty())
+            san += "?";
+        text.add(san);
+
+        // A mating move needs no evaluation, the '#' says it all
+        needNumber = record.scores[ply + 1] != -MATE_SCORE;
+        if (needNumber) {
+            int whiteAfter = white ? -record.scores[ply + 1] : record.scores[ply + 1];
+            std::string comment = "{" + formatScore(whiteAfter);
+            if (loss >= MISTAKE_LOSS && !best.empty())
+                comment += ", best " + best;
+            text.add(comment + "}");   // black's next move then needs its own "N..."
+        }
+
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+    }
+    text.add(game.result);
+    text.finish();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: annotate games.pgn [--out file] [--threads N] [--nodes N] [--hash MB]" << std::endl;
+        return 1;
+    }
+
+    std::string inFile = argv[1];
+    std::string outFile = "annotated.pgn";
+    int threads = (int)std::thread::hardware_concurrency();
+    uint64_t nodeBudget = 20000;
+    int hashMegabytes = 4;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--out") outFile = value;
+        else if (key == "--threads") threads = std::atoi(value.c_str());
+        else if (key == "--nodes") nodeBudget = (uint64_t)std::atoll(value.c_str());
+        else if (key == "--hash") hashMegabytes = std::atoi(value.c_str());
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+    if (threads < 1)
+        threads = 1;
+
+    std::ifstream in(inFile);
+    if (!in) {
+        std::cerr << "Failed to open " << inFile << std::endl;
+        return 1;
+    }
+    std::ofstream out(outFile);
+    if (!out) {
+        std::cerr << "Failed to write " << outFile << std::endl;
+        return 1;
+    }
+
+    BoundedQueue<std::shared_ptr<GameRecord>> jobs((size_t)threads * 2);
+    BoundedQueue<std::shared_ptr<GameRecord>> finished((size_t)threads * 4);
+    InFlightWindow window((size_t)threads * 8);
+
+    std::thread reader([&]() {
+        PgnReader pgn(in);
+        PgnGame game;
+        for (size_t index = 0; pgn.next(game); ++index) {
+            window.acquire();
+            auto record = std::make_shared<GameRecord>();
+            record->index = index;
+            record->game = std::move(game);
+            size_t positions = record->game.moves.size() + 1;
+            record->scores.assign(positions, 0);
+            record->bestMoves.assign(positions, NULL_MOVE);
+            jobs.push(record);
+        }
+        jobs.close();
+    });
+
+    std::atomic<int> activeWorkers(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            Search search(hashMegabytes);
+            std::shared_ptr<GameRecord> job;
+            while (jobs.pop(job)) {
+                GameRecord& record = *job;
+                Position pos;
+                if (record.game.startFen.empty() || !pos.setFromFEN(record.game.startFen))
+                    pos.setStartPosition();
+                search.clear();
+
+                for (size_t ply = 0; ply < record.scores.size(); ++ply) {
+                    MoveList legal;
+                    generateLegalMoves(pos, legal);
+                    if (legal.size() == 0) {
+                        record.scores[ply] = pos.inCheck() ? -MATE_SCORE : 0;
+                    } else {
+                        SearchLimits limits;
+                        limits.nodes = nodeBudget;
+                        SearchResult result = search.think(pos, limits);
+                        record.scores[ply] = result.score;
+                        record.bestMoves[ply] = result.bestMove;
+                    }
+                    if (ply < record.game.moves.size()) {
+                        UndoInfo undo;
+                        pos.makeMove(record.game.moves[ply], undo);
+                    }
+                }
+                finished.push(job);
+                job.reset();
+            }
+            if (--activeWorkers == 0)
+                finished.close();
+        });
+    }
+
+    // Games finish out of order; hold them until their turn comes
+    std::map<size_t, std::shared_ptr<GameRecord>> waiting;
+    size_t nextIndex = 0;
+    std::shared_ptr<GameRecord> record;
+    while (finished.pop(record)) {
+        waiting[record->index] = record;
+        while (!waiting.empty() && waiting.begin()->first == nextIndex) {
+            writeGame(out, *waiting.begin()->second);
+            waiting.erase(waiting.begin());
+            ++nextIndex;
+            window.release();
+        }
+    }
+
+    reader.join();
+    for (auto& t : workers)
+        t.join();
+    std::cout << "Annotated " << nextIndex << " games" << std::endl;
+    return 0;
+}
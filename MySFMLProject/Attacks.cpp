@@ -0,0 +1,8 @@
+#include "Attacks.h"
+
+// Evaluated entirely at compile time and placed in read-only data
+constexpr AttackTables attackTables;
+
+static_assert(attackTables.knight[0] == ((1ULL << 10) | (1ULL << 17)), "knight table");
+static_assert(attackTables.between[56][63] == 0x7E00000000000000ULL, "between table");
+static_assert(attackTables.distance[0][63] == 7, "distance table");
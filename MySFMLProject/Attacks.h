@@ -0,0 +1,119 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include <cstdint>
+
+// Bitboard helpers. Bit n is square n, with the same row * 8 + col layout as Board.
+inline int popCount(uint64_t b) { return __builtin_popcountll(b); }
+inline int lsb(uint64_t b) { return __builtin_ctzll(b); }
+inline int msb(uint64_t b) { return 63 - __builtin_clzll(b); }
+inline int popLsb(uint64_t& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+inline uint64_t squareBit(int sq) { return 1ULL << sq; }
+
+// Ray directions as (row, col) steps; the first four are rook lines, the rest diagonals
+constexpr int DIR_ROW[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+constexpr int DIR_COL[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+
+// Every lookup table the move generator and Board need. It is computed by the
+// compiler (see Attacks.cpp) and lives in read-only data, so startup does no work.
+struct AttackTables {
+    uint64_t pawn[2][64] = {};
+    uint64_t knight[64] = {};
+    uint64_t king[64] = {};
+    uint64_t ray[8][64] = {};
+    uint64_t between[64][64] = {};   // squares strictly between two aligned squares
+    uint64_t line[64][64] = {};      // the whole rank, file or diagonal through both
+    uint8_t distance[64][64] = {};   // king steps from one square to the other
+
+    constexpr AttackTables() {
+        const int knightRow[8] = {-2, -2, -1, -1, 1, 1, 2, 2};
+        const int knightCol[8] = {-1, 1, -2, 2, -2, 2, -1, 1};
+
+        for (int sq = 0; sq < 64; ++sq) {
+            int row = sq / 8, col = sq % 8;
+
+            for (int i = 0; i < 8; ++i) {
+                knight[sq] |= bit(row + knightRow[i], col + knightCol[i]);
+                king[sq] |= bit(row + DIR_ROW[i], col + DIR_COL[i]);
+            }
+            // White pawns capture towards row 0, black pawns towards row 7
+            pawn[0][sq] = bit(row - 1, col - 1) | bit(row - 1, col + 1);
+            pawn[1][sq] = bit(row + 1, col - 1) | bit(row + 1, col + 1);
+
+            for (int d = 0; d < 8; ++d) {
+                uint64_t path = 0;
+                for (int r = row + DIR_ROW[d], c = col + DIR_COL[d]; r >= 0 && r < 8 && c >= 0 && c < 8;
+                     r += DIR_ROW[d], c += DIR_COL[d]) {
+                    between[sq][r * 8 + c] = path;
+                    path |= 1ULL << (r * 8 + c);
+                }
+                ray[d][sq] = path;
+            }
+
+            for (int other = 0; other < 64; ++other) {
+                int dr = row - other / 8, dc = col - other % 8;
+                dr = dr < 0 ? -dr : dr;
+                dc = dc < 0 ? -dc : dc;
+                distance[sq][other] = (uint8_t)(dr > dc ? dr : dc);
+            }
+        }
+
+        // Directions come in opposite pairs (0/1, 2/3, 4/7, 5/6)
+        const int opposite[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+        for (int sq = 0; sq < 64; ++sq)
+            for (int d = 0; d < 8; ++d) {
+                uint64_t full = ray[d][sq] | ray[opposite[d]][sq] | (1ULL << sq);
+                uint64_t targets = ray[d][sq];
+                while (targets) {
+                    int target = __builtin_ctzll(targets);
+                    targets &= targets - 1;
+                    line[sq][target] = full;
+                }
+            }
+    }
+
+    static constexpr uint64_t bit(int row, int col) {
+        return row < 0 || row > 7 || col < 0 || col > 7 ? 0 : 1ULL << (row * 8 + col);
+    }
+};
+
+extern const AttackTables attackTables;
+
+inline uint64_t pawnAttacks(int color, int sq) { return attackTables.pawn[color][sq]; }
+inline uint64_t knightAttacks(int sq) { return attackTables.knight[sq]; }
+inline uint64_t kingAttacks(int sq) { return attackTables.king[sq]; }
+inline uint64_t betweenMask(int from, int to) { return attackTables.between[from][to]; }
+inline uint64_t lineMask(int a, int b) { return attackTables.line[a][b]; }
+inline int squareDistance(int a, int b) { return attackTables.distance[a][b]; }
+
+// Attacks along one ray, stopping at (and including) the first blocker
+inline uint64_t rayAttacks(int dir, int sq, uint64_t occupied) {
+    uint64_t attacks = attackTables.ray[dir][sq];
+    uint64_t blockers = attacks & occupied;
+    if (blockers) {
+        // Directions that step towards row 0 or col 0 decrease the square index
+        bool decreasing = DIR_ROW[dir] * 8 + DIR_COL[dir] < 0;
+        attacks ^= attackTables.ray[dir][decreasing ? msb(blockers) : lsb(blockers)];
+    }
+    return attacks;
+}
+
+inline uint64_t bishopAttacks(int sq, uint64_t occupied) {
+    return rayAttacks(4, sq, occupied) | rayAttacks(5, sq, occupied) |
+           rayAttacks(6, sq, occupied) | rayAttacks(7, sq, occupied);
+}
+
+inline uint64_t rookAttacks(int sq, uint64_t occupied) {
+    return rayAttacks(0, sq, occupied) | rayAttacks(1, sq, occupied) |
+           rayAttacks(2, sq, occupied) | rayAttacks(3, sq, occupied);
+}
+
+inline uint64_t queenAttacks(int sq, uint64_t occupied) {
+    return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "Board.h"
+#include "Attacks.h"
+#include "TextureCache.h"
 #include <iostream>
 #include <SFML/Graphics.hpp>
 
@@ -25,38 +27,101 @@ void Board::setupInitialPosition() {
         board[0][i] = pieces[i];
         board[7][i] = "w" + pieces[i].substr(1);
     }
+
+    history.reset(Position());
 }
 
-void Board::loadTextures() {
-    std::string names[] = {"wp", "wr", "wn", "wb", "wq", "wk", "bp", "br", "bn", "bb", "bq", "bk"};
+void Board::commitMove(int fromRow, int fromCol, int row, int col) {
+    int from = fromRow * 8 + fromCol;
+    int to = row * 8 + col;
+    int flags = QUIET;
+    if (board[row][col] != "")
+        flags = CAPTURE;
+    else if (board[fromRow][fromCol][1] == 'p' && squareDistance(from, to) == 2)
+        flags = DOUBLE_PUSH;
 
-    for (const auto& name : names) {
-        sf::Texture tex;
-        if (!tex.loadFromFile("assets/" + name + ".png")) {
-            std::cerr << "Failed to load texture: " << name << std::endl;
-        }
-        textures[name] = tex;
+    history.push(encodeMove(from, to, flags));
+    syncFromHistory();
 
-        sf::Sprite sprite;
-        sprite.setTexture(textures[name]);
-        sprite.setScale(100.0f / tex.getSize().x, 100.0f / tex.getSize().y);
-        sprites[name] = sprite;
-    }
+    const Position& pos = history.position();
+    if (pos.isThreefoldRepetition())
+        std::cout << "Draw by threefold repetition!" << std::endl;
+    else if (pos.isFiftyMoveDraw())
+        std::cout << "Draw by the fifty-move rule!" << std::endl;
+}
+
+void Board::syncFromHistory() {
+    const Position& pos = history.position();
+    for (int r = 0; r < 8; ++r)
+        for (int c = 0; c < 8; ++c)
+            board[r][c] = pieceName(pos.pieceAt(r * 8 + c));
+
+    isWhiteTurn = pos.sideToMove() == WHITE;
+    isTileSelected = false;
+}
+
+bool Board::undoMove() {
+    if (!history.undo())
+        return false;
+    syncFromHistory();
+    return true;
+}
+
+bool Board::redoMove() {
+    if (!history.redo())
+        return false;
+    syncFromHistory();
+    return true;
+}
+
+void Board::jumpToPly(int ply) {
+    history.jumpTo(ply);
+    syncFromHistory();
+}
+
+// Only queues the piece images; they are decoded in the background and the
+// window can open right away
+void Board::loadTextures() {
+    std::string names[] = {"wp", "wr", "wn", "wb", "wq", "wk", "bp", "br", "bn", "bb", "bq", "bk"};
+    for (const auto& name : names)
+        TextureCache::instance().request("assets/" + name + ".png");
 }
 
 void Board::draw(sf::RenderWindow& window) {
     for (int row = 0; row < 8; ++row) {
         for (int col = 0; col < 8; ++col) {
             std::string piece = board[row][col];
-            if (piece != "") {
-                sf::Sprite sprite = sprites[piece];
-                sprite.setPosition(col * 100, row * 100);
-                window.draw(sprite);
+            if (piece == "")
+                continue;
+
+            auto it = sprites.find(piece);
+            if (it == sprites.end()) {
+                const sf::Texture* tex = TextureCache::instance().get("assets/" + piece + ".png");
+                if (!tex) {
+                    drawPlaceholder(window, piece, row, col);
+                    continue;
+                }
+                sf::Sprite sprite(*tex);
+                sprite.setScale(100.0f / tex->getSize().x, 100.0f / tex->getSize().y);
+                it = sprites.emplace(piece, sprite).first;
             }
+            sf::Sprite sprite = it->second;
+            sprite.setPosition(col * 100, row * 100);
+            window.draw(sprite);
         }
     }
 }
 
+// A plain disc in the piece's colour until its image is ready
+void Board::drawPlaceholder(sf::RenderWindow& window, const std::string& piece, int row, int col) {
+    sf::CircleShape disc(30.0f);
+    disc.setPosition(col * 100 + 20.0f, row * 100 + 20.0f);
+    disc.setFillColor(piece[0] == 'w' ? sf::Color(240, 240, 240) : sf::Color(40, 40, 40));
+    disc.setOutlineColor(sf::Color(90, 90, 90));
+    disc.setOutlineThickness(2.0f);
+    window.draw(disc);
+}
+
 void Board::handleClick(int x, int y) {
     int col = x / 100;
     int row = y / 100;
@@ -75,6 +140,9 @@ void Board::handleClick(int x, int y) {
         int fromCol = selectedTile.x;
         int fromRow = selectedTile.y;
         std::string piece = board[fromRow][fromCol];
+        int from = fromRow * 8 + fromCol;
+        int to = row * 8 + col;
+        uint64_t occupied = history.position().occupancy();
 
         // Check if it's a pawn
         if (piece[1] == 'p') {
@@ -84,8 +152,7 @@ void Board::handleClick(int x, int y) {
             // Move one square forward
             if (col == fromCol && row == fromRow + direction && board[row][col] == "") {
                 // Perform the move
-                board[row][col] = piece;
-                board[fromRow][fromCol] = "";
+                commitMove(fromRow, fromCol, row, col);
         
                 // Show "check" message if the opponent's king is in check (no blocking)
                 bool isOpponentWhite = !isWhitePiece;
@@ -95,7 +162,6 @@ void Board::handleClick(int x, int y) {
         
                 // Proceed with turn change without blocking
                 isTileSelected = false;
-                isWhiteTurn = !isWhiteTurn;
                 return;
             }
         
@@ -105,8 +171,7 @@ void Board::handleClick(int x, int y) {
                 board[fromRow + direction][fromCol] == "" && board[row][col] == "") {
         
                 // Perform the move
-                board[row][col] = piece;
-                board[fromRow][fromCol] = "";
+                commitMove(fromRow, fromCol, row, col);
         
                 // Show "check" message if the opponent's king is in check (no blocking)
                 bool isOpponentWhite = !isWhitePiece;
@@ -116,18 +181,16 @@ void Board::handleClick(int x, int y) {
         
                 // Proceed with turn change without blocking
                 isTileSelected = false;
-                isWhiteTurn = !isWhiteTurn;
 
                 return;
             }
         
             // Diagonal capture (one step diagonally if enemy piece)
-            if ((col == fromCol + 1 || col == fromCol - 1) && row == fromRow + direction) {
+            if (pawnAttacks(isWhitePiece ? WHITE : BLACK, from) & squareBit(to)) {
                 std::string target = board[row][col];
                 if (target != "" && target[0] != piece[0]) {
                     // Perform the move
-                    board[row][col] = piece;
-                    board[fromRow][fromCol] = "";
+                    commitMove(fromRow, fromCol, row, col);
         
                     // Show "check" message if the opponent's king is in check (no blocking)
                     bool isOpponentWhite = !isWhitePiece;
@@ -137,7 +200,6 @@ void Board::handleClick(int x, int y) {
         
                     // Proceed with turn change without blocking
                     isTileSelected = false;
-                    isWhiteTurn = !isWhiteTurn;
 
                     return;
                 }
@@ -152,17 +214,13 @@ void Board::handleClick(int x, int y) {
     else if (piece[1] == 'n') {
     bool isWhitePiece = piece[0] == 'w';
     
-    int dx = std::abs(col - fromCol);
-    int dy = std::abs(row - fromRow);
-    
     // Check L-shape move
-    if ((dx == 2 && dy == 1) || (dx == 1 && dy == 2)) {
+    if (knightAttacks(from) & squareBit(to)) {
         std::string target = board[row][col];
 
         // Allow move if target is empty or opponent's piece
         if (target == "" || target[0] != piece[0]) {
-            board[row][col] = piece;
-            board[fromRow][fromCol] = "";
+            commitMove(fromRow, fromCol, row, col);
             
             // Show "check" message if the opponent's king is in check (no blocking)
             if (isKingInCheck(-1, -1, !isWhitePiece)) {
@@ -170,7 +228,6 @@ void Board::handleClick(int x, int y) {
             }
             
             isTileSelected = false;
-            isWhiteTurn = !isWhiteTurn;  // Toggle turns
             return;
         }
     }
@@ -182,28 +239,11 @@ void Board::handleClick(int x, int y) {
         else if (piece[1] == 'r') {
             bool isWhitePiece = piece[0] == 'w';
             
-            // Moving in straight line
-            if (fromRow == row || fromCol == col) {
-                int rowDir = (row - fromRow) == 0 ? 0 : (row - fromRow) / std::abs(row - fromRow);
-                int colDir = (col - fromCol) == 0 ? 0 : (col - fromCol) / std::abs(col - fromCol);
-            
-                int r = fromRow + rowDir;
-                int c = fromCol + colDir;
-            
-                // Check for obstacles
-                while (r != row || c != col) {
-                    if (board[r][c] != "") {
-                        isTileSelected = false;
-                        return; // Blocked!
-                    }
-                    r += rowDir;
-                    c += colDir;
-                }
-            
+            // Moving in straight line with no obstacles
+            if (rookAttacks(from, occupied) & squareBit(to)) {
                 std::string target = board[row][col];
                 if (target == "" || target[0] != piece[0]) {
-                    board[row][col] = piece;
-                    board[fromRow][fromCol] = "";
+                    commitMove(fromRow, fromCol, row, col);
                     
                     // Show "check" message if the opponent's king is in check (no blocking)
                     if (isKingInCheck(-1, -1, !isWhitePiece)) {
@@ -211,7 +251,6 @@ void Board::handleClick(int x, int y) {
                     }
                     
                     isTileSelected = false;
-                    isWhiteTurn = !isWhiteTurn;  // Toggle turns
                     return;
                 }
             }
@@ -223,31 +262,11 @@ void Board::handleClick(int x, int y) {
         else if (piece[1] == 'b') {
             bool isWhitePiece = piece[0] == 'w';
             
-            int dx = col - fromCol;
-            int dy = row - fromRow;
-            
-            // Must move diagonally (equal steps)
-            if (std::abs(dx) == std::abs(dy)) {
-                int rowDir = dy / std::abs(dy);
-                int colDir = dx / std::abs(dx);
-            
-                int r = fromRow + rowDir;
-                int c = fromCol + colDir;
-            
-                // Check for obstacles
-                while (r != row && c != col) {
-                    if (board[r][c] != "") {
-                        isTileSelected = false;
-                        return; // Blocked!
-                    }
-                    r += rowDir;
-                    c += colDir;
-                }
-            
+            // Must move diagonally with no obstacles
+            if (bishopAttacks(from, occupied) & squareBit(to)) {
                 std::string target = board[row][col];
                 if (target == "" || target[0] != piece[0]) {
-                    board[row][col] = piece;
-                    board[fromRow][fromCol] = "";
+                    commitMove(fromRow, fromCol, row, col);
                     
                     // Show "check" message if the opponent's king is in check (no blocking)
                     if (isKingInCheck(-1, -1, !isWhitePiece)) {
@@ -255,7 +274,6 @@ void Board::handleClick(int x, int y) {
                     }
                     
                     isTileSelected = false;
-                    isWhiteTurn = !isWhiteTurn;  // Toggle turns
                     return;
                 }
             }
@@ -267,31 +285,11 @@ void Board::handleClick(int x, int y) {
         else if (piece[1] == 'q') {
             bool isWhitePiece = piece[0] == 'w';
             
-            int dx = col - fromCol;
-            int dy = row - fromRow;
-            
-            int rowDir = (dy == 0) ? 0 : dy / std::abs(dy);
-            int colDir = (dx == 0) ? 0 : dx / std::abs(dx);
-            
-            // Must be straight or diagonal
-            if ((fromRow == row || fromCol == col) || (std::abs(dx) == std::abs(dy))) {
-                int r = fromRow + rowDir;
-                int c = fromCol + colDir;
-            
-                // Check path
-                while (r != row || c != col) {
-                    if (board[r][c] != "") {
-                        isTileSelected = false;
-                        return; // Blocked
-                    }
-                    r += rowDir;
-                    c += colDir;
-                }
-            
+            // Must be straight or diagonal with a clear path
+            if (queenAttacks(from, occupied) & squareBit(to)) {
                 std::string target = board[row][col];
                 if (target == "" || target[0] != piece[0]) {
-                    board[row][col] = piece;
-                    board[fromRow][fromCol] = "";
+                    commitMove(fromRow, fromCol, row, col);
                     
                     // Show "check" message if the opponent's king is in check (no blocking)
                     if (isKingInCheck(-1, -1, !isWhitePiece)) {
@@ -299,7 +297,6 @@ void Board::handleClick(int x, int y) {
                     }
                     
                     isTileSelected = false;
-                    isWhiteTurn = !isWhiteTurn;  // Toggle turns
                     return;
                 }
             }
@@ -312,15 +309,11 @@ void Board::handleClick(int x, int y) {
         else if (piece[1] == 'k') {
             bool isWhitePiece = piece[0] == 'w';
             
-            int dx = std::abs(col - fromCol);
-            int dy = std::abs(row - fromRow);
-            
             // King moves only 1 square in any direction
-            if (dx <= 1 && dy <= 1) {
+            if (kingAttacks(from) & squareBit(to)) {
                 std::string target = board[row][col];
                 if (target == "" || target[0] != piece[0]) {
-                    board[row][col] = piece;
-                    board[fromRow][fromCol] = "";
+                    commitMove(fromRow, fromCol, row, col);
                     
                     // Show "check" message if the opponent's king is in check (no blocking)
                     if (isKingInCheck(-1, -1, !isWhitePiece)) {
@@ -328,7 +321,6 @@ void Board::handleClick(int x, int y) {
                     }
                     
                     isTileSelected = false;
-                    isWhiteTurn = !isWhiteTurn;  // Toggle turns
                     return;
                 }
             }
@@ -345,99 +337,9 @@ void Board::handleClick(int x, int y) {
 
 
 bool Board::isKingInCheck(int kingRow, int kingCol, bool isWhiteKing) {
-    std::string opponentPrefix = isWhiteKing ? "b" : "w";
-
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            std::string piece = board[row][col];
-            if (piece != "" && piece[0] == opponentPrefix[0]) {
-                // Check if this piece can attack the king
-                if (piece[1] == 'p') {
-                    // Check pawn captures
-                    int direction = piece[0] == 'w' ? -1 : 1;
-                    if (std::abs(col - kingCol) == 1 && row == kingRow + direction) {
-                        return true;
-                    }
-                } else if (piece[1] == 'n') {
-                    // Check knight
-                    int dx = std::abs(col - kingCol);
-                    int dy = std::abs(row - kingRow);
-                    if ((dx == 2 && dy == 1) || (dx == 1 && dy == 2)) {
-                        return true;
-                    }
-                } else if (piece[1] == 'r') {
-                    // Check rook
-                    if (row == kingRow || col == kingCol) {
-                        int rDir = (row == kingRow) ? 0 : (row - kingRow) / std::abs(row - kingRow);
-                        int cDir = (col == kingCol) ? 0 : (col - kingCol) / std::abs(col - kingCol);
-
-                        int r = kingRow + rDir;
-                        int c = kingCol + cDir;
-
-                        bool isBlocked = false;
-                        while (r != row || c != col) {
-                            if (board[r][c] != "") {
-                                isBlocked = true;
-                                break;
-                            }
-                            r += rDir;
-                            c += cDir;
-                        }
-                        if (!isBlocked) {
-                            return true;
-                        }
-                    }
-                } else if (piece[1] == 'b') {
-                    // Check bishop
-                    if (std::abs(col - kingCol) == std::abs(row - kingRow)) {
-                        int rDir = (row - kingRow) / std::abs(row - kingRow);
-                        int cDir = (col - kingCol) / std::abs(col - kingCol);
-
-                        int r = kingRow + rDir;
-                        int c = kingCol + cDir;
-
-                        bool isBlocked = false;
-                        while (r != row || c != col) {
-                            if (board[r][c] != "") {
-                                isBlocked = true;
-                                break;
-                            }
-                            r += rDir;
-                            c += cDir;
-                        }
-                        if (!isBlocked) {
-                            return true;
-                        }
-                    }
-                } else if (piece[1] == 'q') {
-                    // Check queen (same as rook + bishop combined)
-                    if (row == kingRow || col == kingCol || std::abs(col - kingCol) == std::abs(row - kingRow)) {
-                        int rDir = (row == kingRow) ? 0 : (row - kingRow) / std::abs(row - kingRow);
-                        int cDir = (col == kingCol) ? 0 : (col - kingCol) / std::abs(col - kingCol);
-
-                        int r = kingRow + rDir;
-                        int c = kingCol + cDir;
-
-                        bool isBlocked = false;
-                        while (r != row || c != col) {
-                            if (board[r][c] != "") {
-                                isBlocked = true;
-                                break;
-                            }
-                            r += rDir;
-                            c += cDir;
-                        }
-                        if (!isBlocked) {
-                            return true;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    return false;
+    const Position& pos = history.position();
+    int color = isWhiteKing ? WHITE : BLACK;
+    // Callers that do not know where the king is pass -1
+    int kingSquare = kingRow < 0 ? pos.kingSquare(color) : kingRow * 8 + kingCol;
+    return pos.isSquareAttacked(kingSquare, color ^ 1);
 }
-
-
-
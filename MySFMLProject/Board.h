@@ -2,6 +2,7 @@
 #define BOARD_H
 
 #include <SFML/Graphics.hpp>
+#include "GameHistory.h"
 #include <string>
 #include <map>
 
@@ -13,19 +14,30 @@ public:
     void handleClick(int x, int y);
     bool isKingInCheck(int kingRow, int kingCol, bool isWhiteKing);
 
+    // Game review: step or jump through the moves played so far
+    bool undoMove();
+    bool redoMove();
+    void jumpToPly(int ply);
+    int currentPly() const { return history.ply(); }
+    int gameLength() const { return history.length(); }
+
 
 private:
     std::string board[8][8];
-    std::map<std::string, sf::Texture> textures;
+    // Filled in by draw() as TextureCache finishes each piece image
     std::map<std::string, sf::Sprite> sprites;
     sf::Vector2i selectedTile = {-1, -1};
     bool isTileSelected = false;
     bool isWhiteTurn = true;
+    GameHistory history;
     
 
 
 
     void setupInitialPosition();
+    void commitMove(int fromRow, int fromCol, int row, int col);
+    void syncFromHistory();
+    void drawPlaceholder(sf::RenderWindow& window, const std::string& piece, int row, int col);
 };
 
 #endif
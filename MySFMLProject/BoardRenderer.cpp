@@ -0,0 +1,112 @@
+#include "BoardRenderer.h"
+#include <iostream>
+
+namespace {
+
+// The tile colours used by the game window (main.cpp)
+const sf::Uint8 LIGHT_SQUARE[3] = {255, 255, 255};
+const sf::Uint8 DARK_SQUARE[3] = {118, 150, 86};
+
+// Resamples source to size x size pixels. Each output pixel averages a grid of
+// bilinear samples over the area it covers, so large reductions do not alias.
+// Colour is weighted by alpha, otherwise transparent pixels darken the edges.
+std::vector<sf::Uint8> scaleImage(const sf::Image& source, int size) {
+    int srcW = (int)source.getSize().x, srcH = (int)source.getSize().y;
+    const sf::Uint8* src = source.getPixelsPtr();
+    std::vector<sf::Uint8> out((size_t)size * size * 4, 0);
+    if (srcW == 0 || srcH == 0)
+        return out;
+
+    int samples = (srcW + size - 1) / size;
+    if (samples < 1)
+        samples = 1;
+    float scaleX = (float)srcW / size, scaleY = (float)srcH / size;
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float sum[4] = {0, 0, 0, 0};
+            for (int sy = 0; sy < samples; ++sy) {
+                for (int sx = 0; sx < samples; ++sx) {
+                    float fx = (x + (sx + 0.5f) / samples) * scaleX - 0.5f;
+                    float fy = (y + (sy + 0.5f) / samples) * scaleY - 0.5f;
+                    int x0 = (int)(fx < 0 ? 0 : fx), y0 = (int)(fy < 0 ? 0 : fy);
+                    int x1 = x0 + 1 < srcW ? x0 + 1 : x0, y1 = y0 + 1 < srcH ? y0 + 1 : y0;
+                    float tx = fx - x0, ty = fy - y0;
+                    tx = tx < 0 ? 0 : tx;
+                    ty = ty < 0 ? 0 : ty;
+
+                    const int xs[4] = {x0, x1, x0, x1}, ys[4] = {y0, y0, y1, y1};
+                    const float weights[4] = {(1 - tx) * (1 - ty), tx * (1 - ty), (1 - tx) * ty, tx * ty};
+                    for (int k = 0; k < 4; ++k) {
+                        const sf::Uint8* p = src + ((size_t)ys[k] * srcW + xs[k]) * 4;
+                        float alpha = p[3] * weights[k];
+                        sum[0] += p[0] * alpha;
+                        sum[1] += p[1] * alpha;
+                        sum[2] += p[2] * alpha;
+                        sum[3] += alpha;
+                    }
+                }
+            }
+
+            sf::Uint8* d = &out[((size_t)y * size + x) * 4];
+            if (sum[3] > 0) {
+                for (int c = 0; c < 3; ++c)
+                    d[c] = (sf::Uint8)(sum[c] / sum[3] + 0.5f);
+                d[3] = (sf::Uint8)(sum[3] / (samples * samples) + 0.5f);
+            }
+        }
+    }
+    return out;
+}
+
+}
+
+bool BoardRenderer::loadPieces(const std::string& assetDir) {
+    bool ok = true;
+    for (int piece = 0; piece < 12; ++piece) {
+        std::string path = assetDir + "/" + pieceName(piece) + ".png";
+        if (!sources[piece].loadFromFile(path)) {
+            std::cerr << "Failed to load texture: " << path << std::endl;
+            ok = false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    scaledSets.clear();
+    return ok;
+}
+
+const BoardRenderer::PieceSet& BoardRenderer::piecesFor(int tileSize) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::unique_ptr<PieceSet>& set = scaledSets[tileSize];
+    if (!set) {
+        set.reset(new PieceSet);
+        for (int piece = 0; piece < 12; ++piece)
+            set->pixels[piece] = scaleImage(sources[piece], tileSize);
+    }
+    return *set;
+}
+
+void BoardRenderer::render(const Position& pos, int tileSize, sf::Image& image) {
+    const PieceSet& pieces = piecesFor(tileSize);
+    int size = tileSize * 8;
+    std::vector<sf::Uint8> pixels((size_t)size * size * 4);
+
+    for (int sq = 0; sq < 64; ++sq) {
+        int row = sq / 8, col = sq % 8;
+        const sf::Uint8* square = (row + col) % 2 == 0 ? LIGHT_SQUARE : DARK_SQUARE;
+        int piece = pos.pieceAt(sq);
+        const sf::Uint8* sprite = piece == NO_PIECE ? nullptr : pieces.pixels[piece].data();
+
+        for (int y = 0; y < tileSize; ++y) {
+            sf::Uint8* d = &pixels[(((size_t)row * tileSize + y) * size + (size_t)col * tileSize) * 4];
+            const sf::Uint8* s = sprite ? sprite + (size_t)y * tileSize * 4 : nullptr;
+            for (int x = 0; x < tileSize; ++x, d += 4) {
+                int alpha = s ? s[x * 4 + 3] : 0;
+                for (int c = 0; c < 3; ++c)
+                    d[c] = alpha ? (sf::Uint8)((s[x * 4 + c] * alpha + square[c] * (255 - alpha) + 127) / 255) : square[c];
+                d[3] = 255;
+            }
+        }
+    }
+    image.create((unsigned)size, (unsigned)size, pixels.data());
+}
@@ -0,0 +1,37 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include <SFML/Graphics/Image.hpp>
+#include "Position.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Draws board diagrams into an sf::Image on the CPU, with the same colours and
+// piece images as the game window but without a window or GL context.
+// Piece images are scaled once per tile size and cached, so after
+// loadPieces() any number of threads can call render() at the same time.
+class BoardRenderer {
+public:
+    // Loads wp.png ... bk.png from assetDir; false if any is missing
+    bool loadPieces(const std::string& assetDir = "assets");
+
+    // The image is (8 * tileSize) pixels square, rank 8 at the top
+    void render(const Position& pos, int tileSize, sf::Image& image);
+
+private:
+    // Straight-alpha RGBA, tileSize * tileSize pixels per piece
+    struct PieceSet {
+        std::vector<sf::Uint8> pixels[12];
+    };
+
+    sf::Image sources[12];
+    std::mutex cacheMutex;
+    std::map<int, std::unique_ptr<PieceSet>> scaledSets;
+
+    const PieceSet& piecesFor(int tileSize);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Blocking multi-producer, multi-consumer FIFO with a fixed capacity. A full
+// queue makes producers wait, so a fast stage cannot run ahead of a slow one
+// and memory stays bounded.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity ? capacity : 1), closed(false) {}
+
+    // Waits for room; returns false (dropping item) once the queue is closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Waits for an item; returns false when the queue is closed and drained
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // No more pushes; consumers finish what is queued and then see false
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+};
+
+// Counts items between two pipeline stages that may complete out of order, so
+// a producer can be held back until the in-order consumer catches up: acquire()
+// before handing an item on, release() once it has been consumed.
+class InFlightWindow {
+public:
+    explicit InFlightWindow(size_t limit) : limit(limit ? limit : 1) {}
+
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return count < limit; });
+        ++count;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        --count;
+        changed.notify_one();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t limit;
+    size_t count = 0;
+};
+
+#endif
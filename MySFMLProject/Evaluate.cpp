@@ -0,0 +1,167 @@
+#include "Evaluate.h"
+#include "Attacks.h"
+#include "Kpk.h"
+
+namespace {
+
+const int PHASE_WEIGHT[6] = {0, 1, 1, 2, 4, 0};
+
+// Score of a won ending that is known exactly; well above any material edge, well below mate
+const int KNOWN_WIN = 10000;
+
+const int PAWN_TABLE[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int KNIGHT_TABLE[64] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+const int BISHOP_TABLE[64] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+const int ROOK_TABLE[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+const int QUEEN_TABLE[64] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+const int KING_MG_TABLE[64] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+const int KING_EG_TABLE[64] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+EvalParams defaultParams() {
+    EvalParams p;
+    const int materialMg[6] = {100, 320, 330, 500, 900, 0};
+    const int materialEg[6] = {120, 300, 320, 520, 940, 0};
+    const int* tables[6] = {PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_MG_TABLE};
+
+    for (int type = PAWN; type <= KING; ++type) {
+        p.materialMg[type] = materialMg[type];
+        p.materialEg[type] = materialEg[type];
+        for (int sq = 0; sq < 64; ++sq) {
+            p.pstMg[type][sq] = tables[type][sq];
+            p.pstEg[type][sq] = type == KING ? KING_EG_TABLE[sq] : tables[type][sq];
+        }
+    }
+    p.bishopPairMg = 30;
+    p.bishopPairEg = 50;
+    p.tempo = 10;
+    return p;
+}
+
+// King and pawn against king: exact from the bitbase, scored from the side to move
+int evaluateKpk(const Position& pos) {
+    int strong = pos.pieces(makePiece(WHITE, PAWN)) ? WHITE : BLACK;
+    int flip = strong == WHITE ? 0 : 56;
+    int pawn = lsb(pos.pieces(makePiece(strong, PAWN))) ^ flip;
+    bool strongToMove = pos.sideToMove() == strong;
+
+    if (!kpkProbe(pos.kingSquare(strong) ^ flip, pawn, pos.kingSquare(strong ^ 1) ^ flip, strongToMove))
+        return 0;
+    // Prefer the line that brings the pawn closer to promotion
+    int score = KNOWN_WIN + evalParams.materialEg[PAWN] + (7 - pawn / 8) * 10;
+    return strongToMove ? score : -score;
+}
+
+}
+
+EvalParams evalParams = defaultParams();
+
+int gamePhase(const Position& pos) {
+    int phase = 0;
+    for (int type = KNIGHT; type <= QUEEN; ++type)
+        phase += PHASE_WEIGHT[type] * popCount(pos.pieces(makePiece(WHITE, type)) | pos.pieces(makePiece(BLACK, type)));
+    return phase < MAX_PHASE ? phase : MAX_PHASE;
+}
+
+bool isKpk(const Position& pos) {
+    return popCount(pos.occupancy()) == 3 && (pos.pieces(makePiece(WHITE, PAWN)) | pos.pieces(makePiece(BLACK, PAWN)));
+}
+
+int evaluate(const Position& pos) {
+    if (isKpk(pos))
+        return evaluateKpk(pos);
+
+    const EvalParams& p = evalParams;
+    int mg = 0, eg = 0;
+
+    for (int color = WHITE; color <= BLACK; ++color) {
+        int sign = color == WHITE ? 1 : -1;
+        int flip = color == WHITE ? 0 : 56;
+
+        for (int type = PAWN; type <= KING; ++type) {
+            uint64_t pieces = pos.pieces(makePiece(color, type));
+            while (pieces) {
+                int sq = popLsb(pieces) ^ flip;
+                mg += sign * (p.materialMg[type] + p.pstMg[type][sq]);
+                eg += sign * (p.materialEg[type] + p.pstEg[type][sq]);
+            }
+        }
+
+        if (popCount(pos.pieces(makePiece(color, BISHOP))) >= 2) {
+            mg += sign * p.bishopPairMg;
+            eg += sign * p.bishopPairEg;
+        }
+    }
+
+    int phase = gamePhase(pos);
+    int score = (mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE;
+    return (pos.sideToMove() == WHITE ? score : -score) + p.tempo;
+}
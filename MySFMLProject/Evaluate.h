@@ -0,0 +1,33 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "Position.h"
+
+// Game phase runs from 24 (all minor and major pieces on the board) down to 0
+const int MAX_PHASE = 24;
+
+// Tapered evaluation terms, each as a middlegame/endgame pair.
+// Piece-square tables are written from White's point of view with rank 8 on top,
+// which matches the square layout, so Black reads them through sq ^ 56.
+struct EvalParams {
+    int materialMg[6];
+    int materialEg[6];
+    int pstMg[6][64];
+    int pstEg[6][64];
+    int bishopPairMg;
+    int bishopPairEg;
+    int tempo;
+};
+
+extern EvalParams evalParams;
+
+int gamePhase(const Position& pos);
+
+// King and pawn against king, which evaluate() scores from the KPK bitbase
+// instead of the tapered terms below
+bool isKpk(const Position& pos);
+
+// Static evaluation in centipawns from the side to move's point of view
+int evaluate(const Position& pos);
+
+#endif
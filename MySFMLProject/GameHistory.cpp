@@ -0,0 +1,68 @@
+#include "GameHistory.h"
+
+GameHistory::GameHistory() {
+    reset(Position());
+}
+
+GameHistory::GameHistory(const Position& start) {
+    reset(start);
+}
+
+void GameHistory::reset(const Position& start) {
+    pos = start;
+    entries.clear();
+    checkpoints.clear();
+    checkpoints.push_back(start);
+    current = 0;
+}
+
+void GameHistory::push(Move m) {
+    entries.resize(current);
+    checkpoints.resize(current / CHECKPOINT_INTERVAL + 1);
+
+    Entry entry;
+    entry.move = m;
+    pos.makeMove(m, entry.undo);
+    entries.push_back(entry);
+    ++current;
+
+    if (current % CHECKPOINT_INTERVAL == 0)
+        checkpoints.push_back(pos);
+}
+
+bool GameHistory::undo() {
+    if (current == 0)
+        return false;
+    --current;
+    pos.unmakeMove(entries[current].move, entries[current].undo);
+    return true;
+}
+
+bool GameHistory::redo() {
+    if (current == length())
+        return false;
+    // The undo record is a pure function of position and move, so it is simply rewritten
+    pos.makeMove(entries[current].move, entries[current].undo);
+    ++current;
+    return true;
+}
+
+void GameHistory::jumpTo(int targetPly) {
+    if (targetPly < 0)
+        targetPly = 0;
+    if (targetPly > length())
+        targetPly = length();
+
+    // Short hops step through the move list, longer ones restart from a checkpoint
+    int distance = targetPly > current ? targetPly - current : current - targetPly;
+    if (distance > CHECKPOINT_INTERVAL / 2) {
+        int index = targetPly / CHECKPOINT_INTERVAL;
+        pos = checkpoints[index];
+        current = index * CHECKPOINT_INTERVAL;
+    }
+
+    while (current > targetPly)
+        undo();
+    while (current < targetPly)
+        redo();
+}
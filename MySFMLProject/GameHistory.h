@@ -0,0 +1,43 @@
+#ifndef GAME_HISTORY_H
+#define GAME_HISTORY_H
+
+#include "Position.h"
+#include <vector>
+
+// Move list of one game with undo/redo and random access to any ply.
+// Each ply costs a 16-bit move plus its UndoInfo; a full Position is cached
+// every CHECKPOINT_INTERVAL plies so jumpTo never replays more than that.
+class GameHistory {
+public:
+    static const int CHECKPOINT_INTERVAL = 16;
+
+    GameHistory();
+    explicit GameHistory(const Position& start);
+
+    void reset(const Position& start);
+
+    // Plays m at the current ply, discarding any moves that could have been redone
+    void push(Move m);
+    bool undo();
+    bool redo();
+    void jumpTo(int targetPly);
+
+    int ply() const { return current; }
+    int length() const { return (int)entries.size(); }
+    Move moveAt(int index) const { return entries[index].move; }
+    const Position& position() const { return pos; }
+
+private:
+    struct Entry {
+        Move move;
+        UndoInfo undo;
+    };
+
+    Position pos;
+    std::vector<Entry> entries;
+    // checkpoints[i] is the position before ply i * CHECKPOINT_INTERVAL
+    std::vector<Position> checkpoints;
+    int current;
+};
+
+#endif
@@ -0,0 +1,122 @@
+// Headless chess game server. All games live in one GameStore and every client
+// is served from a single sf::SocketSelector loop, so there is one thread and no
+// per-game rendering state. A client can own any number of games; see
+// GameStore::handleCommand for the line protocol.
+//
+// Client sockets are non-blocking, so a client that stops reading cannot stall
+// the loop: its replies wait in its output buffer and are retried on every pass
+// (the selector only reports readable sockets, so the loop wakes up every few
+// milliseconds while any output is pending). A client whose backlog passes
+// MAX_PENDING_OUTPUT is disconnected.
+//
+// Usage: gameserver [port]    (default 5555)
+
+#include "GameStore.h"
+#include <SFML/Network.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+
+const std::size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+struct Client {
+    int id;
+    std::unique_ptr<sf::TcpSocket> socket;
+    std::string pending;   // bytes received after the last complete line
+    std::string output;    // replies the socket has not taken yet
+};
+
+// Sends as much of the client's output as the socket accepts right now;
+// false once the connection is gone
+static bool flushOutput(Client& client) {
+    while (!client.output.empty()) {
+        std::size_t sent = 0;
+        sf::Socket::Status status = client.socket->send(client.output.data(), client.output.size(), sent);
+        client.output.erase(0, sent);
+        if (status == sf::Socket::Done)
+            continue;
+        if (status == sf::Socket::Partial || status == sf::Socket::NotReady)
+            return true;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short port = argc > 1 ? (unsigned short)std::atoi(argv[1]) : 5555;
+
+    sf::TcpListener listener;
+    if (listener.listen(port) != sf::Socket::Done) {
+        std::cerr << "Failed to listen on port " << port << std::endl;
+        return 1;
+    }
+    std::cout << "Game server listening on port " << port << std::endl;
+
+    GameStore store;
+    std::list<Client> clients;
+    int nextClientId = 0;
+    bool outputPending = false;
+    sf::SocketSelector selector;
+    selector.add(listener);
+
+    for (;;) {
+        // Block until something arrives, or poll while replies are waiting to go out.
+        // Without a timeout wait() only returns false on an error.
+        bool ready = selector.wait(outputPending ? sf::milliseconds(5) : sf::Time::Zero);
+        if (!ready && !outputPending)
+            break;
+
+        if (selector.isReady(listener)) {
+            Client client;
+            client.id = nextClientId++;
+            client.socket.reset(new sf::TcpSocket);
+            if (listener.accept(*client.socket) == sf::Socket::Done) {
+                client.socket->setBlocking(false);
+                selector.add(*client.socket);
+                clients.push_back(std::move(client));
+            }
+        }
+
+        outputPending = false;
+        for (auto it = clients.begin(); it != clients.end();) {
+            sf::TcpSocket& socket = *it->socket;
+            bool connected = true;
+
+            if (selector.isReady(socket)) {
+                char buffer[4096];
+                std::size_t received = 0;
+                sf::Socket::Status status = socket.receive(buffer, sizeof(buffer), received);
+                if (status == sf::Socket::Done) {
+                    it->pending.append(buffer, received);
+                    std::size_t newline;
+                    while ((newline = it->pending.find('\n')) != std::string::npos) {
+                        std::string line = it->pending.substr(0, newline);
+                        it->pending.erase(0, newline + 1);
+                        if (!line.empty() && line.back() == '\r')
+                            line.pop_back();
+                        if (!line.empty())
+                            it->output += store.handleCommand(it->id, line) + "\n";
+                    }
+                } else if (status != sf::Socket::NotReady) {
+                    connected = false;
+                }
+            }
+
+            // Batch all replies to this read into as few sends as the socket allows
+            if (connected)
+                connected = flushOutput(*it) && it->output.size() <= MAX_PENDING_OUTPUT;
+            if (!connected) {
+                store.releaseClient(it->id);
+                selector.remove(socket);
+                it = clients.erase(it);
+                continue;
+            }
+            outputPending = outputPending || !it->output.empty();
+            ++it;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "GameStore.h"
+#include "MoveGen.h"
+#include <sstream>
+
+int GameStore::createGame(int client) {
+    Game game;
+    game.position = packPosition(Position());
+    game.status = GAME_ONGOING;
+    game.active = true;
+    game.owners[0] = client;
+    game.owners[1] = NO_CLIENT;
+
+    // Reuse slots of finished games so the table stays dense
+    if (!freeIds.empty()) {
+        int id = freeIds.back();
+        freeIds.pop_back();
+        games[id] = game;
+        return id;
+    }
+    games.push_back(game);
+    return (int)games.size() - 1;
+}
+
+bool GameStore::endGame(int id) {
+    if (!isActive(id))
+        return false;
+    games[id].active = false;
+    std::vector<Move>().swap(games[id].moves);
+    freeIds.push_back(id);
+    return true;
+}
+
+bool GameStore::joinGame(int id, int client) {
+    if (!isActive(id))
+        return false;
+    Game& game = games[id];
+    if (game.owners[0] == client || game.owners[1] == client)
+        return true;
+    if (game.owners[1] != NO_CLIENT)
+        return false;
+    game.owners[1] = client;
+    return true;
+}
+
+void GameStore::releaseClient(int client) {
+    for (int id = 0; id < (int)games.size(); ++id) {
+        Game& game = games[id];
+        if (!game.active)
+            continue;
+        for (int& owner : game.owners)
+            if (owner == client)
+                owner = NO_CLIENT;
+        if (game.owners[0] == NO_CLIENT && game.owners[1] == NO_CLIENT)
+            endGame(id);
+    }
+}
+
+bool GameStore::isActive(int id) const {
+    return id >= 0 && id < (int)games.size() && games[id].active;
+}
+
+bool GameStore::isOwner(int id, int client) const {
+    return isActive(id) && client != NO_CLIENT &&
+           (games[id].owners[0] == client || games[id].owners[1] == client);
+}
+
+bool GameStore::isToMove(int id, int client) const {
+    if (!isActive(id) || client == NO_CLIENT)
+        return false;
+    // Bit 0 of the packed position is the side to move
+    return games[id].owners[games[id].position.sideAndCastling & 1] == client;
+}
+
+bool GameStore::isThreefold(const Game& game) const {
+    // The packed position has no hash history, so replay the game to rebuild it
+    Position pos;
+    for (Move m : game.moves) {
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+    }
+    return pos.isThreefoldRepetition();
+}
+
+bool GameStore::playMove(int id, int client, const std::string& text, GameStatus& status) {
+    if (!isActive(id) || games[id].status != GAME_ONGOING || !isToMove(id, client))
+        return false;
+
+    Game& game = games[id];
+    Position pos;
+    unpackPosition(game.position, pos);
+    Move m = parseMove(pos, text);
+    if (m == NULL_MOVE)
+        return false;
+
+    UndoInfo undo;
+    pos.makeMove(m, undo);
+    game.moves.push_back(m);
+    game.position = packPosition(pos);
+
+    MoveList replies;
+    generateLegalMoves(pos, replies);
+    if (replies.size() == 0)
+        game.status = pos.inCheck() ? GAME_CHECKMATE : GAME_STALEMATE;
+    else if (pos.isFiftyMoveDraw() || pos.hasInsufficientMaterial())
+        game.status = GAME_DRAW;
+    else if (pos.halfmoveClock() >= 8 && isThreefold(game))
+        game.status = GAME_DRAW;
+
+    status = game.status;
+    return true;
+}
+
+bool GameStore::getFEN(int id, std::string& fen) const {
+    if (!isActive(id))
+        return false;
+    Position pos;
+    unpackPosition(games[id].position, pos);
+    fen = pos.toFEN();
+    return true;
+}
+
+std::string GameStore::handleCommand(int client, const std::string& line) {
+    static const char* STATUS_NAMES[] = {"ongoing", "checkmate", "stalemate", "draw"};
+
+    std::istringstream in(line);
+    std::string command, move;
+    int id = -1;
+    in >> command >> id >> move;
+
+    if (command == "new")
+        return "game " + std::to_string(createGame(client));
+
+    if (command == "join") {
+        if (!isActive(id))
+            return "error unknown game " + std::to_string(id);
+        if (!joinGame(id, client))
+            return "error game full " + std::to_string(id);
+        return "joined " + std::to_string(id);
+    }
+
+    if ((command == "move" || command == "end") && isActive(id) && !isOwner(id, client))
+        return "error not your game " + std::to_string(id);
+
+    if (command == "move") {
+        if (isActive(id) && !isToMove(id, client))
+            return "error not your turn " + std::to_string(id);
+        GameStatus status;
+        if (!playMove(id, client, move, status))
+            return "illegal " + std::to_string(id);
+        return "ok " + std::to_string(id) + " " + move + " " + STATUS_NAMES[status];
+    }
+
+    if (command == "fen") {
+        std::string fen;
+        if (!getFEN(id, fen))
+            return "error unknown game " + std::to_string(id);
+        return "fen " + std::to_string(id) + " " + fen;
+    }
+
+    if (command == "end") {
+        if (!endGame(id))
+            return "error unknown game " + std::to_string(id);
+        return "ended " + std::to_string(id);
+    }
+
+    return "error unknown command";
+}
@@ -0,0 +1,65 @@
+#ifndef GAME_STORE_H
+#define GAME_STORE_H
+
+#include "PackedPosition.h"
+#include <string>
+#include <vector>
+
+enum GameStatus : uint8_t {
+    GAME_ONGOING,
+    GAME_CHECKMATE,
+    GAME_STALEMATE,
+    GAME_DRAW
+};
+
+const int NO_CLIENT = -1;
+
+// Holds many concurrent games for the server, each as a 32-byte packed position
+// plus its move list (about 64 bytes per game before moves), instead of a Board
+// with its own textures and sprites.
+//
+// Every game belongs to the client that created it, who plays white, and to at
+// most one client that joined it, who plays black. Only those two may end it,
+// each may only move for its own colour, and anyone may read its FEN.
+class GameStore {
+public:
+    int createGame(int client);
+    bool joinGame(int id, int client);
+    bool endGame(int id);
+    // The client disconnected: it gives up its games, and games nobody owns any more end
+    void releaseClient(int client);
+
+    // Validates the move with the move generator and plays it if client plays the side to move
+    bool playMove(int id, int client, const std::string& text, GameStatus& status);
+    bool getFEN(int id, std::string& fen) const;
+    bool isOwner(int id, int client) const;
+    bool isToMove(int id, int client) const;
+    size_t activeGames() const { return games.size() - freeIds.size(); }
+
+    // One request line of the text protocol from client in, one reply line out:
+    //     new                 -> game <id>
+    //     join <id>           -> joined <id>, or error game full <id>
+    //     move <id> <e2e4>    -> ok <id> <move> <ongoing|checkmate|stalemate|draw>, or illegal <id>
+    //     fen <id>            -> fen <id> <fen>
+    //     end <id>            -> ended <id>
+    // move and end from a client that does not own the game get error not your game <id>,
+    // and move from an owner whose colour is not to move gets error not your turn <id>.
+    std::string handleCommand(int client, const std::string& line);
+
+private:
+    struct Game {
+        PackedPosition position;
+        std::vector<Move> moves;
+        GameStatus status;
+        bool active;
+        int owners[2];   // by colour: the creator plays white, the client that joined black; NO_CLIENT when free
+    };
+
+    std::vector<Game> games;
+    std::vector<int> freeIds;
+
+    bool isActive(int id) const;
+    bool isThreefold(const Game& game) const;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include "Kpk.h"
+#include <cstdint>
+
+namespace {
+
+// Solved offline by KpkGenerate.cpp and compiled in as read-only data
+constexpr uint64_t KPK_BITS[] = {
+#include "KpkBitbase.inc"
+};
+
+static_assert(sizeof(KPK_BITS) * 8 == KPK_POSITIONS, "KpkBitbase.inc does not match the index layout");
+
+}
+
+bool kpkProbe(int strongKing, int pawn, int weakKing, bool strongToMove) {
+    // Only files a-d are stored; the board is symmetric left to right
+    if (pawn % 8 > 3) {
+        strongKing ^= 7;
+        weakKing ^= 7;
+        pawn ^= 7;
+    }
+    int index = kpkIndex(strongToMove, strongKing, weakKing, pawn);
+    return (KPK_BITS[index / 64] >> (index % 64)) & 1;
+}
@@ -0,0 +1,19 @@
+#ifndef KPK_H
+#define KPK_H
+
+// King and pawn versus king, solved exactly and stored as one bit per position.
+// Positions are seen from the pawn side as White: for a black pawn mirror the
+// rows (sq ^ 56) and swap the side to move.
+
+// 2 sides to move * 24 pawn squares (files a-d, rows 1-6) * 64 * 64 kings = 24 KB of bits
+const int KPK_POSITIONS = 2 * 24 * 64 * 64;
+
+// The pawn must be on files a-d and rows 1-6
+constexpr int kpkIndex(bool strongToMove, int strongKing, int weakKing, int pawn) {
+    return strongKing | (weakKing << 6) | ((strongToMove ? 1 : 0) << 12) | ((pawn % 8) << 13) | ((pawn / 8 - 1) << 15);
+}
+
+// True if the pawn side wins, false if the position is a draw (any pawn square)
+bool kpkProbe(int strongKing, int pawn, int weakKing, bool strongToMove);
+
+#endif
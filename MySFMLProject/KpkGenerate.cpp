@@ -0,0 +1,127 @@
+// Solves king and pawn versus king and writes the result as KpkBitbase.inc,
+// the table Kpk.cpp compiles into the binary. Only needs to be run again if
+// the index layout in Kpk.h changes.
+//
+// Usage: kpkgenerate [KpkBitbase.inc]
+
+#include "Attacks.h"
+#include "Kpk.h"
+#include "Position.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+enum KpkResult : uint8_t { KPK_INVALID = 0, KPK_UNKNOWN = 1, KPK_DRAW = 2, KPK_WIN = 4 };
+
+int strongKingOf(int index) { return index & 63; }
+int weakKingOf(int index) { return (index >> 6) & 63; }
+bool strongToMoveOf(int index) { return (index >> 12) & 1; }
+int pawnOf(int index) { return ((index >> 15) + 1) * 8 + ((index >> 13) & 3); }
+
+uint8_t initial(int index) {
+    int strongKing = strongKingOf(index), weakKing = weakKingOf(index), pawn = pawnOf(index);
+    bool strongToMove = strongToMoveOf(index);
+
+    if (squareDistance(strongKing, weakKing) <= 1 || strongKing == pawn || weakKing == pawn ||
+        (strongToMove && (pawnAttacks(WHITE, pawn) & squareBit(weakKing))))
+        return KPK_INVALID;
+
+    // The pawn promotes next move and the new queen cannot be taken
+    if (strongToMove && pawn / 8 == 1) {
+        int queen = pawn - 8;
+        if (strongKing != queen && weakKing != queen &&
+            (squareDistance(weakKing, queen) > 1 || squareDistance(strongKing, queen) <= 1))
+            return KPK_WIN;
+    }
+
+    if (!strongToMove) {
+        uint64_t guarded = pawnAttacks(WHITE, pawn) | kingAttacks(strongKing);
+        // Stalemate, or the lone king takes an undefended pawn
+        if (!(kingAttacks(weakKing) & ~guarded) ||
+            (kingAttacks(weakKing) & ~kingAttacks(strongKing) & squareBit(pawn)))
+            return KPK_DRAW;
+    }
+    return KPK_UNKNOWN;
+}
+
+uint8_t classify(int index, const std::vector<uint8_t>& results) {
+    int strongKing = strongKingOf(index), weakKing = weakKingOf(index), pawn = pawnOf(index);
+    bool strongToMove = strongToMoveOf(index);
+
+    // The side to move gets its own outcome (WIN for the strong side, DRAW for
+    // the weak one) if any move reaches it, and the other one if every move
+    // leads there
+    uint8_t good = strongToMove ? KPK_WIN : KPK_DRAW;
+    uint8_t bad = strongToMove ? KPK_DRAW : KPK_WIN;
+    uint8_t seen = 0;
+
+    uint64_t moves = kingAttacks(strongToMove ? strongKing : weakKing);
+    while (moves) {
+        int to = popLsb(moves);
+        seen |= strongToMove ? results[kpkIndex(false, to, weakKing, pawn)]
+                             : results[kpkIndex(true, strongKing, to, pawn)];
+    }
+
+    if (strongToMove && pawn / 8 > 1) {
+        int push = pawn - 8;
+        if (push != strongKing && push != weakKing) {
+            seen |= results[kpkIndex(false, strongKing, weakKing, push)];
+            // Double push from the second rank (row 6)
+            if (pawn / 8 == 6 && push - 8 != strongKing && push - 8 != weakKing)
+                seen |= results[kpkIndex(false, strongKing, weakKing, push - 8)];
+        }
+    }
+
+    if (seen & good)
+        return good;
+    if (seen & KPK_UNKNOWN)
+        return KPK_UNKNOWN;
+    return bad;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "KpkBitbase.inc";
+
+    std::vector<uint8_t> results(KPK_POSITIONS);
+    for (int index = 0; index < KPK_POSITIONS; ++index)
+        results[index] = initial(index);
+
+    // Propagate until nothing changes; whatever is still open is a draw
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int index = 0; index < KPK_POSITIONS; ++index) {
+            if (results[index] != KPK_UNKNOWN)
+                continue;
+            uint8_t result = classify(index, results);
+            if (result != KPK_UNKNOWN) {
+                results[index] = result;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<uint64_t> bits(KPK_POSITIONS / 64, 0);
+    int wins = 0;
+    for (int index = 0; index < KPK_POSITIONS; ++index) {
+        if (results[index] == KPK_WIN) {
+            bits[index / 64] |= 1ULL << (index % 64);
+            ++wins;
+        }
+    }
+
+    FILE* out = std::fopen(path, "w");
+    if (!out) {
+        std::fprintf(stderr, "Failed to write %s\n", path);
+        return 1;
+    }
+    std::fprintf(out, "// Generated by KpkGenerate.cpp, do not edit. One bit per kpkIndex(), set when the pawn wins.\n");
+    for (size_t i = 0; i < bits.size(); ++i)
+        std::fprintf(out, "0x%016llxULL,%c", (unsigned long long)bits[i], i % 4 == 3 ? '\n' : ' ');
+    std::fclose(out);
+    std::printf("%d wins out of %d positions, wrote %s\n", wins, KPK_POSITIONS, path);
+    return 0;
+}
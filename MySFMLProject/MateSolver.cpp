@@ -0,0 +1,199 @@
+#include "MateSolver.h"
+#include "MoveGen.h"
+
+namespace {
+
+// Proof numbers saturate here; a node with phi or delta at INF is solved
+const uint32_t INF = 1u << 30;
+
+uint32_t saturate(uint64_t value) {
+    return value >= INF ? INF : (uint32_t)value;
+}
+
+}
+
+MateSolver::MateSolver(int hashMegabytes) : nodes(0), nodeLimit(0), onlyChecks(false) {
+    uint64_t count = 1;
+    uint64_t wanted = (uint64_t)hashMegabytes * 1024 * 1024 / sizeof(Entry);
+    while (count * 2 <= wanted)
+        count *= 2;
+    table.resize(count);
+    mask = count - 1;
+    clear();
+}
+
+void MateSolver::clear() {
+    Entry empty = {0, NULL_MOVE, 1, 1};
+    table.assign(table.size(), empty);
+}
+
+uint64_t MateSolver::nodeKey(const Position& pos, int pliesLeft) {
+    // Results depend on the remaining depth, so it is folded into the key
+    return pos.hash() ^ ((uint64_t)(pliesLeft + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+void MateSolver::lookup(uint64_t key, uint32_t& phi, uint32_t& delta) const {
+    const Entry& entry = table[key & mask];
+    if (entry.lock == key >> 16) {
+        phi = entry.phi;
+        delta = entry.delta;
+    } else {
+        phi = delta = 1;
+    }
+}
+
+void MateSolver::store(uint64_t key, uint32_t phi, uint32_t delta, Move best) {
+    Entry& entry = table[key & mask];
+    entry.lock = key >> 16;
+    entry.best = best;
+    entry.phi = phi;
+    entry.delta = delta;
+}
+
+void MateSolver::generateChildren(Position& pos, bool attacker, MoveList& moves) {
+    MoveList list;
+    generateLegalMoves(pos, list);
+    for (int i = 0; i < list.size(); ++i) {
+        if (attacker && onlyChecks) {
+            UndoInfo undo;
+            pos.makeMove(list[i], undo);
+            bool check = pos.inCheck();
+            pos.unmakeMove(list[i], undo);
+            if (!check)
+                continue;
+        }
+        moves.add(list[i]);
+    }
+}
+
+// Multiple-iterative-deepening step of df-pn in phi/delta form: phi is the proof
+// number at attacker nodes and the disproof number at defender nodes, delta the other.
+void MateSolver::mid(Position& pos, int pliesLeft, bool attacker, uint32_t thresholdPhi, uint32_t thresholdDelta) {
+    ++nodes;
+    uint64_t key = nodeKey(pos, pliesLeft);
+
+    // Solved leaves: the attacker has failed with (phi, delta) = (INF, 0) at its own
+    // nodes and (0, INF) at defender nodes, and has succeeded with the reverse
+    uint32_t failPhi = attacker ? INF : 0;
+    uint32_t failDelta = attacker ? 0 : INF;
+
+    if (pos.isRepetition()) {
+        store(key, failPhi, failDelta);
+        return;
+    }
+
+    MoveList moves;
+    generateChildren(pos, attacker, moves);
+    if (moves.size() == 0) {
+        if (!attacker && pos.inCheck())
+            store(key, INF, 0);
+        else
+            store(key, failPhi, failDelta);
+        return;
+    }
+    if (!attacker && pliesLeft == 0) {
+        store(key, failPhi, failDelta);
+        return;
+    }
+
+    uint64_t childKeys[256];
+    for (int i = 0; i < moves.size(); ++i) {
+        UndoInfo undo;
+        pos.makeMove(moves[i], undo);
+        childKeys[i] = nodeKey(pos, pliesLeft - 1);
+        pos.unmakeMove(moves[i], undo);
+    }
+
+    for (;;) {
+        uint32_t phi = INF;
+        uint64_t deltaSum = 0;
+        int best = 0;
+        uint32_t bestPhi = 0, bestDelta = INF, secondDelta = INF;
+
+        for (int i = 0; i < moves.size(); ++i) {
+            uint32_t childPhi, childDelta;
+            lookup(childKeys[i], childPhi, childDelta);
+            if (childDelta < phi)
+                phi = childDelta;
+            deltaSum += childPhi;
+            if (childDelta < bestDelta) {
+                secondDelta = bestDelta;
+                bestDelta = childDelta;
+                bestPhi = childPhi;
+                best = i;
+            } else if (childDelta < secondDelta) {
+                secondDelta = childDelta;
+            }
+        }
+
+        uint32_t delta = saturate(deltaSum);
+        bool outOfNodes = nodeLimit && nodes >= nodeLimit;
+        if (phi >= thresholdPhi || delta >= thresholdDelta || outOfNodes) {
+            store(key, phi, delta, moves[best]);
+            return;
+        }
+
+        // Search the most promising child until it is no longer the cheapest one
+        uint32_t childThresholdPhi = saturate((uint64_t)thresholdDelta + bestPhi - delta);
+        uint32_t childThresholdDelta = thresholdPhi < secondDelta + 1 ? thresholdPhi : saturate((uint64_t)secondDelta + 1);
+
+        UndoInfo undo;
+        pos.makeMove(moves[best], undo);
+        mid(pos, pliesLeft - 1, !attacker, childThresholdPhi, childThresholdDelta);
+        pos.unmakeMove(moves[best], undo);
+    }
+}
+
+Move MateSolver::findMatingMove(Position& pos, int pliesLeft) {
+    // The root was stored last, so its entry and the move that proved it are still there
+    uint64_t key = nodeKey(pos, pliesLeft);
+    const Entry& root = table[key & mask];
+    if (root.lock == key >> 16 && root.phi == 0 && root.best != NULL_MOVE)
+        return (Move)root.best;
+
+    // Otherwise look for a proven defender node among the children, re-proving each
+    // one in turn; most of its subtree is still in the table, so this stays short
+    MoveList moves;
+    generateChildren(pos, true, moves);
+    for (int i = 0; i < moves.size(); ++i) {
+        Move m = moves[i];
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        uint32_t childPhi, childDelta;
+        lookup(nodeKey(pos, pliesLeft - 1), childPhi, childDelta);
+        if (childDelta != 0 && childPhi != 0) {
+            mid(pos, pliesLeft - 1, false, INF, INF);
+            lookup(nodeKey(pos, pliesLeft - 1), childPhi, childDelta);
+        }
+        pos.unmakeMove(m, undo);
+        if (childDelta == 0)
+            return m;
+    }
+    return NULL_MOVE;
+}
+
+MateResult MateSolver::solve(Position& pos, int mateInMoves, uint64_t maxNodes, bool checksOnly) {
+    MateResult result;
+    if (checksOnly != onlyChecks) {
+        // Disproofs found with checks only do not hold for the full move set
+        onlyChecks = checksOnly;
+        clear();
+    }
+    nodes = 0;
+    nodeLimit = maxNodes;
+
+    int pliesLeft = mateInMoves * 2 - 1;
+    if (pliesLeft < 1)
+        return result;
+
+    mid(pos, pliesLeft, true, INF, INF);
+
+    uint32_t phi, delta;
+    lookup(nodeKey(pos, pliesLeft), phi, delta);
+    result.mate = phi == 0;
+    result.aborted = phi != 0 && delta != 0;
+    if (result.mate)
+        result.firstMove = findMatingMove(pos, pliesLeft);
+    result.nodes = nodes;
+    return result;
+}
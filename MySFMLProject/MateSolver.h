@@ -0,0 +1,52 @@
+#ifndef MATE_SOLVER_H
+#define MATE_SOLVER_H
+
+#include "MoveGen.h"
+#include <cstdint>
+#include <vector>
+
+struct MateResult {
+    bool mate = false;      // the side to move forces mate within the asked number of moves
+    bool aborted = false;   // node budget ran out before a proof or disproof
+    Move firstMove = NULL_MOVE;
+    uint64_t nodes = 0;
+};
+
+// Depth-first proof-number (df-pn) search for forced mates. It only asks "can
+// the side to move force mate in N?", so it skips evaluation entirely and
+// spends its effort on the lines with the fewest defences left to refute.
+// Proof and disproof numbers live in a fixed-size table, so memory use is capped.
+class MateSolver {
+public:
+    explicit MateSolver(int hashMegabytes = 64);
+
+    void clear();
+    // checksOnly restricts the attacker to checking moves, which is much faster
+    // but misses mates that start with a quiet move
+    MateResult solve(Position& pos, int mateInMoves, uint64_t maxNodes = 0, bool checksOnly = false);
+
+private:
+    // 16 bytes: the move shares a word with the top 48 bits of the key, which
+    // together with the slot index identify the node
+    struct Entry {
+        uint64_t lock : 48;
+        uint64_t best : 16;   // the child searched last; the mating move once an attacker node is proven
+        uint32_t phi;
+        uint32_t delta;
+    };
+
+    std::vector<Entry> table;
+    uint64_t mask;
+    uint64_t nodes;
+    uint64_t nodeLimit;
+    bool onlyChecks;
+
+    static uint64_t nodeKey(const Position& pos, int pliesLeft);
+    void lookup(uint64_t key, uint32_t& phi, uint32_t& delta) const;
+    void store(uint64_t key, uint32_t phi, uint32_t delta, Move best = NULL_MOVE);
+    void generateChildren(Position& pos, bool attacker, MoveList& moves);
+    Move findMatingMove(Position& pos, int pliesLeft);
+    void mid(Position& pos, int pliesLeft, bool attacker, uint32_t thresholdPhi, uint32_t thresholdDelta);
+};
+
+#endif
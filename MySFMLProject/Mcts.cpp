@@ -0,0 +1,239 @@
+#include "Mcts.h"
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int64_t MCTS_VALUE_ONE = 1 << 16;
+const float EXPLORATION = 1.4f;
+const uint32_t NO_NODE = 0xFFFFFFFF;
+
+float winProbability(int score) {
+    return 1.0f / (1.0f + std::pow(10.0f, -score / 400.0f));
+}
+
+// Game over at pos, from the side to move's point of view; negative if the game goes on
+float terminalValue(Position& pos, int legalMoves) {
+    if (legalMoves == 0)
+        return pos.inCheck() ? 0.0f : 0.5f;
+    if (pos.isRepetition() || pos.isFiftyMoveDraw() || pos.hasInsufficientMaterial())
+        return 0.5f;
+    return -1.0f;
+}
+
+}
+
+float StaticEvalLeaf::evaluate(Position& pos, std::mt19937&) {
+    return winProbability(::evaluate(pos));
+}
+
+float RandomPlayoutLeaf::evaluate(Position& pos, std::mt19937& rng) {
+    std::vector<std::pair<Move, UndoInfo>> played;
+    float value = -1.0f;
+    for (int ply = 0; ply < maxPlies; ++ply) {
+        MoveList list;
+        generateLegalMoves(pos, list);
+        value = terminalValue(pos, list.size());
+        if (value >= 0.0f)
+            break;
+        Move m = list[(int)(rng() % list.size())];
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        played.emplace_back(m, undo);
+    }
+    if (value < 0.0f)
+        value = winProbability(::evaluate(pos));
+
+    // Report the value for the side to move at the start of the playout
+    if (played.size() % 2)
+        value = 1.0f - value;
+    for (size_t i = played.size(); i-- > 0;)
+        pos.unmakeMove(played[i].first, played[i].second);
+    return value;
+}
+
+std::unique_ptr<LeafEvaluator> makeLeafEvaluator(const std::string& name) {
+    if (name == "eval")
+        return std::unique_ptr<LeafEvaluator>(new StaticEvalLeaf);
+    if (name == "playout")
+        return std::unique_ptr<LeafEvaluator>(new RandomPlayoutLeaf);
+    return nullptr;
+}
+
+MctsSearch::MctsSearch(int threads, int arenaMegabytes, const std::string& leafEvaluator)
+    : threads(threads > 0 ? threads : 1), leafName(leafEvaluator), arenaUsed(0), stopRequested(false),
+      playouts(0) {
+    arenaSize = (uint32_t)((size_t)arenaMegabytes * 1024 * 1024 / sizeof(MctsNode));
+    if (arenaSize < 1024)
+        arenaSize = 1024;
+    arena.reset(new MctsNode[arenaSize]);
+}
+
+uint32_t MctsSearch::allocate(int count) {
+    uint32_t first = arenaUsed.fetch_add((uint32_t)count);
+    if (first + (uint32_t)count > arenaSize)
+        return NO_NODE;
+    return first;
+}
+
+void MctsSearch::expand(MctsNode& node, Position& pos) {
+    uint8_t expected = 0;
+    if (!node.state.compare_exchange_strong(expected, 1))
+        return;   // another worker got here first
+
+    MoveList list;
+    generateLegalMoves(pos, list);
+    uint32_t first = list.size() ? allocate(list.size()) : NO_NODE;
+    if (first == NO_NODE) {
+        // Terminal, or the arena is full: the node stays a leaf for good
+        return;
+    }
+    for (int i = 0; i < list.size(); ++i) {
+        MctsNode& child = arena[first + i];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.valueSum.store(0, std::memory_order_relaxed);
+        child.state.store(0, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.move = list[i];
+    }
+    node.firstChild = first;
+    node.childCount = (uint16_t)list.size();
+    node.state.store(2, std::memory_order_release);
+}
+
+// UCT: the child's average result plus a bonus for being rarely tried.
+// Unvisited children come first.
+int MctsSearch::selectChild(const MctsNode& node) const {
+    float logParent = std::log((float)(node.visits.load(std::memory_order_relaxed) + 1));
+    int best = 0;
+    float bestScore = -1.0f;
+    for (int i = 0; i < node.childCount; ++i) {
+        const MctsNode& child = arena[node.firstChild + i];
+        int visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return i;
+        float mean = (float)child.valueSum.load(std::memory_order_relaxed) / MCTS_VALUE_ONE / visits;
+        float score = mean + EXPLORATION * std::sqrt(logParent / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void MctsSearch::worker(const Position& root, const SearchLimits& limits,
+                        std::chrono::steady_clock::time_point start) {
+    Position pos = root;
+    std::unique_ptr<LeafEvaluator> leaf = makeLeafEvaluator(leafName);
+    if (!leaf)
+        leaf = makeLeafEvaluator("eval");
+    std::mt19937 rng(std::random_device{}());
+
+    std::vector<uint32_t> path;
+    std::vector<std::pair<Move, UndoInfo>> played;
+    while (!stopRequested) {
+        // Selection: each node on the way down counts a visit with no value yet,
+        // which is the virtual loss other workers see until this playout returns
+        path.assign(1, 0);
+        played.clear();
+        arena[0].visits.fetch_add(1, std::memory_order_relaxed);
+        while (arena[path.back()].state.load(std::memory_order_acquire) == 2 && (int)played.size() < MAX_PLY) {
+            const MctsNode& node = arena[path.back()];
+            uint32_t child = node.firstChild + selectChild(node);
+            arena[child].visits.fetch_add(1, std::memory_order_relaxed);
+            UndoInfo undo;
+            pos.makeMove(arena[child].move, undo);
+            played.emplace_back(arena[child].move, undo);
+            path.push_back(child);
+        }
+
+        // Expansion and evaluation, value for the side to move at the leaf
+        MctsNode& leafNode = arena[path.back()];
+        MoveList list;
+        generateLegalMoves(pos, list);
+        float value = path.size() > 1 ? terminalValue(pos, list.size()) : -1.0f;
+        if (value < 0.0f) {
+            if (leafNode.visits.load(std::memory_order_relaxed) > 1 || path.size() == 1)
+                expand(leafNode, pos);
+            value = leaf->evaluate(pos, rng);
+        }
+
+        // Backpropagation: each node stores the result for the player who moved into it
+        for (size_t i = path.size(); i-- > 0;) {
+            value = 1.0f - value;
+            arena[path[i]].valueSum.fetch_add((int64_t)(value * MCTS_VALUE_ONE), std::memory_order_relaxed);
+        }
+        for (size_t i = played.size(); i-- > 0;)
+            pos.unmakeMove(played[i].first, played[i].second);
+
+        uint64_t done = ++playouts;
+        if (limits.nodes && done >= limits.nodes)
+            stopRequested = true;
+        if (limits.moveTimeMs && (done & 63) == 0 &&
+            std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(limits.moveTimeMs))
+            stopRequested = true;
+    }
+}
+
+SearchResult MctsSearch::think(Position& pos, const SearchLimits& limits) {
+    auto start = std::chrono::steady_clock::now();
+    stopRequested = false;
+    playouts = 0;
+    arenaUsed = 1;
+    MctsNode& root = arena[0];
+    root.visits = 0;
+    root.valueSum = 0;
+    root.state = 0;
+    root.childCount = 0;
+    root.move = NULL_MOVE;
+
+    SearchResult result;
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    if (legal.size() == 0)
+        return result;
+    result.bestMove = legal[0];
+    if (legal.size() == 1 || (!limits.moveTimeMs && !limits.nodes))
+        return result;
+
+    expand(root, pos);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back(&MctsSearch::worker, this, std::cref(pos), std::cref(limits), start);
+    for (auto& t : pool)
+        t.join();
+
+    // The most visited move is the most trusted one; follow visits for the pv
+    uint32_t index = 0;
+    while (arena[index].state.load(std::memory_order_acquire) == 2 && result.pv.size() < (size_t)MAX_PLY) {
+        const MctsNode& node = arena[index];
+        uint32_t best = node.firstChild;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i)
+            if (arena[i].visits > arena[best].visits)
+                best = i;
+        if (arena[best].visits == 0)
+            break;
+        result.pv.push_back(arena[best].move);
+        index = best;
+    }
+    if (!result.pv.empty())
+        result.bestMove = result.pv[0];
+
+    // Report the win rate of the chosen move in centipawns
+    for (uint32_t i = root.firstChild; i < root.firstChild + root.childCount; ++i) {
+        if (arena[i].move != result.bestMove || arena[i].visits == 0)
+            continue;
+        float mean = (float)arena[i].valueSum / MCTS_VALUE_ONE / arena[i].visits;
+        mean = mean < 0.001f ? 0.001f : (mean > 0.999f ? 0.999f : mean);
+        result.score = (int)(-400.0f * std::log10(1.0f / mean - 1.0f));
+    }
+    result.depth = (int)result.pv.size();
+    result.nodes = playouts;
+    result.timeMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    result.stats.nodes = playouts;
+    return result;
+}
@@ -0,0 +1,79 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "Search.h"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+
+// Scores a leaf for the side to move: 1 is a win, 0 a loss, 0.5 a draw
+class LeafEvaluator {
+public:
+    virtual ~LeafEvaluator() {}
+    virtual float evaluate(Position& pos, std::mt19937& rng) = 0;
+};
+
+// Static evaluation squashed into a win probability
+class StaticEvalLeaf : public LeafEvaluator {
+public:
+    float evaluate(Position& pos, std::mt19937& rng) override;
+};
+
+// Random legal moves until the game ends or maxPlies have been played, then
+// the static evaluation of where it got to
+class RandomPlayoutLeaf : public LeafEvaluator {
+public:
+    explicit RandomPlayoutLeaf(int maxPlies = 16) : maxPlies(maxPlies) {}
+    float evaluate(Position& pos, std::mt19937& rng) override;
+
+private:
+    int maxPlies;
+};
+
+// "eval" or "playout"; nullptr for an unknown name
+std::unique_ptr<LeafEvaluator> makeLeafEvaluator(const std::string& name);
+
+struct MctsNode {
+    std::atomic<int32_t> visits;
+    std::atomic<int64_t> valueSum;   // fixed point, MCTS_VALUE_ONE per win, for the player who moved here
+    std::atomic<uint8_t> state;      // 0 leaf, 1 being expanded, 2 children published
+    uint32_t firstChild;             // valid once state is 2
+    uint16_t childCount;
+    Move move;
+};
+
+// Tree-parallel Monte Carlo tree search. All workers share one tree: nodes
+// come from a fixed arena, each descent adds a virtual loss to the nodes on
+// its path so concurrent workers spread out, and the real result replaces it
+// on the way back. Leaves are scored by a LeafEvaluator.
+//
+// think() takes the same limits as the alpha-beta Search (moveTimeMs, nodes as
+// a playout budget) and returns the same SearchResult, so either can be used
+// wherever an engine is needed. depth is ignored; with neither a time nor a
+// node limit it returns the first legal move without searching.
+class MctsSearch {
+public:
+    MctsSearch(int threads = 1, int arenaMegabytes = 64, const std::string& leafEvaluator = "eval");
+
+    SearchResult think(Position& pos, const SearchLimits& limits);
+    void stop() { stopRequested = true; }
+    // The tree is rebuilt on every think(); nothing to forget between games
+    void clear() {}
+
+private:
+    int threads;
+    std::string leafName;
+    std::unique_ptr<MctsNode[]> arena;
+    uint32_t arenaSize;
+    std::atomic<uint32_t> arenaUsed;
+    std::atomic<bool> stopRequested;
+    std::atomic<uint64_t> playouts;
+
+    uint32_t allocate(int count);
+    void expand(MctsNode& node, Position& pos);
+    int selectChild(const MctsNode& node) const;
+    void worker(const Position& root, const SearchLimits& limits, std::chrono::steady_clock::time_point start);
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+
+// A move packed into 16 bits: from (6) | to (6) | flags (4).
+// Squares use the same layout as Board: square = row * 8 + col, row 0 is rank 8.
+typedef uint16_t Move;
+
+const Move NULL_MOVE = 0;
+
+enum MoveFlag {
+    QUIET = 0,
+    DOUBLE_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EP_CAPTURE = 5,
+    PROMO_KNIGHT = 8,
+    PROMO_BISHOP = 9,
+    PROMO_ROOK = 10,
+    PROMO_QUEEN = 11,
+    PROMO_KNIGHT_CAPTURE = 12,
+    PROMO_BISHOP_CAPTURE = 13,
+    PROMO_ROOK_CAPTURE = 14,
+    PROMO_QUEEN_CAPTURE = 15
+};
+
+inline Move encodeMove(int from, int to, int flags) {
+    return (Move)(from | (to << 6) | (flags << 12));
+}
+
+inline int moveFrom(Move m) { return m & 63; }
+inline int moveTo(Move m) { return (m >> 6) & 63; }
+inline int moveFlags(Move m) { return m >> 12; }
+inline bool isCapture(Move m) { return (moveFlags(m) & CAPTURE) != 0; }
+inline bool isPromotion(Move m) { return (moveFlags(m) & 8) != 0; }
+inline bool isCastle(Move m) { return moveFlags(m) == KING_CASTLE || moveFlags(m) == QUEEN_CASTLE; }
+
+// Piece type the pawn becomes (KNIGHT..QUEEN), only valid for promotions
+inline int promotionType(Move m) { return (moveFlags(m) & 3) + 1; }
+
+inline std::string squareName(int sq) {
+    std::string s;
+    s += (char)('a' + sq % 8);
+    s += (char)('8' - sq / 8);
+    return s;
+}
+
+// Long algebraic notation, e.g. "e2e4" or "e7e8q"
+inline std::string moveToString(Move m) {
+    if (m == NULL_MOVE)
+        return "0000";
+    std::string s = squareName(moveFrom(m)) + squareName(moveTo(m));
+    if (isPromotion(m))
+        s += "nbrq"[promotionType(m) - 1];
+    return s;
+}
+
+#endif
@@ -0,0 +1,280 @@
+#include "MoveGen.h"
+#include "Attacks.h"
+#include <cctype>
+
+namespace {
+
+void addPawnMoves(MoveList& list, int from, int to, bool capture) {
+    // Reaching row 0 or row 7 promotes
+    if (to < 8 || to >= 56) {
+        int base = capture ? PROMO_KNIGHT_CAPTURE : PROMO_KNIGHT;
+        for (int promo = 3; promo >= 0; --promo)
+            list.add(encodeMove(from, to, base + promo));
+    } else {
+        list.add(encodeMove(from, to, capture ? CAPTURE : QUIET));
+    }
+}
+
+void generatePawnMoves(const Position& pos, MoveList& list, bool capturesOnly) {
+    int us = pos.sideToMove();
+    int forward = us == WHITE ? -8 : 8;
+    int startRow = us == WHITE ? 6 : 1;
+    uint64_t empty = ~pos.occupancy();
+    uint64_t enemies = pos.occupancy(us ^ 1);
+    uint64_t pawns = pos.pieces(makePiece(us, PAWN));
+
+    while (pawns) {
+        int from = popLsb(pawns);
+        int to = from + forward;
+
+        if (empty & (1ULL << to)) {
+            bool promotes = to < 8 || to >= 56;
+            if (!capturesOnly || promotes)
+                addPawnMoves(list, from, to, false);
+            if (!capturesOnly && from / 8 == startRow && (empty & (1ULL << (to + forward))))
+                list.add(encodeMove(from, to + forward, DOUBLE_PUSH));
+        }
+
+        uint64_t targets = pawnAttacks(us, from) & enemies;
+        while (targets)
+            addPawnMoves(list, from, popLsb(targets), true);
+
+        int ep = pos.enPassantSquare();
+        if (ep != -1 && (pawnAttacks(us, from) & (1ULL << ep)))
+            list.add(encodeMove(from, ep, EP_CAPTURE));
+    }
+}
+
+void addPieceMoves(const Position& pos, MoveList& list, int from, uint64_t attacks, bool capturesOnly) {
+    uint64_t enemies = pos.occupancy(pos.sideToMove() ^ 1);
+    uint64_t captures = attacks & enemies;
+    while (captures)
+        list.add(encodeMove(from, popLsb(captures), CAPTURE));
+    if (capturesOnly)
+        return;
+    uint64_t quiets = attacks & ~pos.occupancy();
+    while (quiets)
+        list.add(encodeMove(from, popLsb(quiets), QUIET));
+}
+
+void generateCastling(const Position& pos, MoveList& list) {
+    int us = pos.sideToMove();
+    int them = us ^ 1;
+    int king = us == WHITE ? 60 : 4;
+    int rights = pos.castlingRights();
+    uint64_t occ = pos.occupancy();
+    int kingSide = us == WHITE ? WHITE_OO : BLACK_OO;
+    int queenSide = us == WHITE ? WHITE_OOO : BLACK_OOO;
+
+    if (!(rights & (kingSide | queenSide)) || pos.isSquareAttacked(king, them))
+        return;
+
+    if ((rights & kingSide) && !(occ & (3ULL << (king + 1))) && !pos.isSquareAttacked(king + 1, them) &&
+        !pos.isSquareAttacked(king + 2, them))
+        list.add(encodeMove(king, king + 2, KING_CASTLE));
+
+    if ((rights & queenSide) && !(occ & (7ULL << (king - 3))) && !pos.isSquareAttacked(king - 1, them) &&
+        !pos.isSquareAttacked(king - 2, them))
+        list.add(encodeMove(king, king - 2, QUEEN_CASTLE));
+}
+
+// Pieces of color that attack sq, with occ standing in for the board occupancy
+uint64_t attackersTo(const Position& pos, int sq, int color, uint64_t occ) {
+    uint64_t queens = pos.pieces(makePiece(color, QUEEN));
+    return (pawnAttacks(color ^ 1, sq) & pos.pieces(makePiece(color, PAWN))) |
+           (knightAttacks(sq) & pos.pieces(makePiece(color, KNIGHT))) |
+           (kingAttacks(sq) & pos.pieces(makePiece(color, KING))) |
+           (bishopAttacks(sq, occ) & (pos.pieces(makePiece(color, BISHOP)) | queens)) |
+           (rookAttacks(sq, occ) & (pos.pieces(makePiece(color, ROOK)) | queens));
+}
+
+// Pieces of color that are the only blocker between their king and an enemy slider
+uint64_t pinnedPieces(const Position& pos, int color) {
+    int them = color ^ 1;
+    int king = pos.kingSquare(color);
+    uint64_t occ = pos.occupancy();
+    uint64_t queens = pos.pieces(makePiece(them, QUEEN));
+    uint64_t snipers = (rookAttacks(king, 0) & (pos.pieces(makePiece(them, ROOK)) | queens)) |
+                       (bishopAttacks(king, 0) & (pos.pieces(makePiece(them, BISHOP)) | queens));
+    uint64_t pinned = 0;
+    while (snipers) {
+        uint64_t blockers = betweenMask(king, popLsb(snipers)) & occ;
+        if (blockers && !(blockers & (blockers - 1)))
+            pinned |= blockers & pos.occupancy(color);
+    }
+    return pinned;
+}
+
+void generate(const Position& pos, MoveList& list, bool capturesOnly) {
+    int us = pos.sideToMove();
+    uint64_t occ = pos.occupancy();
+    uint64_t own = pos.occupancy(us);
+
+    generatePawnMoves(pos, list, capturesOnly);
+
+    for (int type = KNIGHT; type <= KING; ++type) {
+        uint64_t pieces = pos.pieces(makePiece(us, type));
+        while (pieces) {
+            int from = popLsb(pieces);
+            uint64_t attacks;
+            switch (type) {
+                case KNIGHT: attacks = knightAttacks(from); break;
+                case BISHOP: attacks = bishopAttacks(from, occ); break;
+                case ROOK:   attacks = rookAttacks(from, occ); break;
+                case QUEEN:  attacks = queenAttacks(from, occ); break;
+                default:     attacks = kingAttacks(from); break;
+            }
+            addPieceMoves(pos, list, from, attacks & ~own, capturesOnly);
+        }
+    }
+
+    if (!capturesOnly)
+        generateCastling(pos, list);
+}
+
+}
+
+void generatePseudoLegalMoves(const Position& pos, MoveList& list) {
+    generate(pos, list, false);
+}
+
+void generateCaptures(const Position& pos, MoveList& list) {
+    generate(pos, list, true);
+}
+
+void generateLegalMoves(Position& pos, MoveList& list) {
+    MoveList pseudo;
+    generatePseudoLegalMoves(pos, pseudo);
+
+    // Checkers and pinned pieces are found once, so most moves are accepted or
+    // rejected from bitboards alone without making them
+    int us = pos.sideToMove();
+    int them = us ^ 1;
+    int king = pos.kingSquare(us);
+    uint64_t occ = pos.occupancy();
+    uint64_t checkers = attackersTo(pos, king, them, occ);
+    uint64_t pinned = pinnedPieces(pos, us);
+    // Non-king moves must capture the checker or block it; with two checkers none can
+    uint64_t evasionTargets = ~0ULL;
+    if (checkers)
+        evasionTargets = popCount(checkers) > 1 ? 0 : checkers | betweenMask(king, lsb(checkers));
+
+    for (int i = 0; i < pseudo.size(); ++i) {
+        Move m = pseudo[i];
+        int from = moveFrom(m), to = moveTo(m);
+        bool legal;
+        if (moveFlags(m) == EP_CAPTURE)
+            legal = isLegal(pos, m);   // two pawns leave the rank at once, let makeMove sort it out
+        else if (from == king)
+            legal = isCastle(m) || !attackersTo(pos, to, them, occ ^ squareBit(king));
+        else
+            legal = (evasionTargets & squareBit(to)) &&
+                    (!(pinned & squareBit(from)) || (lineMask(king, from) & squareBit(to)));
+        if (legal)
+            list.add(m);
+    }
+}
+
+bool isLegal(Position& pos, Move m) {
+    int us = pos.sideToMove();
+    UndoInfo undo;
+    pos.makeMove(m, undo);
+    bool legal = !pos.isSquareAttacked(pos.kingSquare(us), us ^ 1);
+    pos.unmakeMove(m, undo);
+    return legal;
+}
+
+Move parseMove(Position& pos, const std::string& text) {
+    MoveList list;
+    generateLegalMoves(pos, list);
+    for (int i = 0; i < list.size(); ++i)
+        if (moveToString(list[i]) == text)
+            return list[i];
+    return NULL_MOVE;
+}
+
+namespace {
+
+// SAN without the check or mate suffix
+std::string sanBody(const Position& pos, Move m, const MoveList& legal) {
+    if (moveFlags(m) == KING_CASTLE)
+        return "O-O";
+    if (moveFlags(m) == QUEEN_CASTLE)
+        return "O-O-O";
+
+    int from = moveFrom(m), to = moveTo(m);
+    int type = pieceType(pos.pieceAt(from));
+    std::string san;
+    if (type == PAWN) {
+        if (isCapture(m))
+            san += (char)('a' + from % 8);
+    } else {
+        san += "PNBRQK"[type];
+        // Name the file, else the rank, else both, of the moving piece when
+        // another piece of the same type can reach the same square
+        bool ambiguous = false, sameFile = false, sameRank = false;
+        for (int i = 0; i < legal.size(); ++i) {
+            int other = moveFrom(legal[i]);
+            if (moveTo(legal[i]) != to || other == from || pos.pieceAt(other) != pos.pieceAt(from))
+                continue;
+            ambiguous = true;
+            sameFile |= other % 8 == from % 8;
+            sameRank |= other / 8 == from / 8;
+        }
+        if (ambiguous) {
+            if (!sameFile)
+                san += (char)('a' + from % 8);
+            else if (!sameRank)
+                san += (char)('8' - from / 8);
+            else
+                san += squareName(from);
+        }
+    }
+    if (isCapture(m))
+        san += 'x';
+    san += squareName(to);
+    if (isPromotion(m)) {
+        san += '=';
+        san += "NBRQ"[promotionType(m) - 1];
+    }
+    return san;
+}
+
+}
+
+std::string moveToSan(Position& pos, Move m) {
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    std::string san = sanBody(pos, m, legal);
+
+    UndoInfo undo;
+    pos.makeMove(m, undo);
+    if (pos.inCheck()) {
+        MoveList replies;
+        generateLegalMoves(pos, replies);
+        san += replies.size() == 0 ? '#' : '+';
+    }
+    pos.unmakeMove(m, undo);
+    return san;
+}
+
+Move parseSan(Position& pos, const std::string& text) {
+    std::string san = text;
+    while (!san.empty() && std::string("+#!?").find(san.back()) != std::string::npos)
+        san.pop_back();
+    if (san == "0-0")
+        san = "O-O";
+    else if (san == "0-0-0")
+        san = "O-O-O";
+    // Some writers leave out the '=' of a promotion ("e8Q")
+    size_t n = san.size();
+    if (n >= 3 && std::isdigit((unsigned char)san[n - 2]) && std::string("NBRQ").find(san[n - 1]) != std::string::npos)
+        san.insert(n - 1, "=");
+
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    for (int i = 0; i < legal.size(); ++i)
+        if (sanBody(pos, legal[i], legal) == san)
+            return legal[i];
+    return NULL_MOVE;
+}
@@ -0,0 +1,29 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "Position.h"
+
+struct MoveList {
+    Move moves[256];
+    int count = 0;
+
+    void add(Move m) { moves[count++] = m; }
+    Move operator[](int i) const { return moves[i]; }
+    int size() const { return count; }
+};
+
+// Pseudo-legal moves may leave the mover's king in check; search filters them with isLegal
+void generatePseudoLegalMoves(const Position& pos, MoveList& list);
+// Captures and promotions only, for quiescence search
+void generateCaptures(const Position& pos, MoveList& list);
+void generateLegalMoves(Position& pos, MoveList& list);
+
+bool isLegal(Position& pos, Move m);
+// Finds the legal move matching a long algebraic string such as "e2e4" or "e7e8q"
+Move parseMove(Position& pos, const std::string& text);
+// Standard algebraic notation as used in PGN, e.g. "Nbd7", "exd5", "e8=Q+", "O-O"
+std::string moveToSan(Position& pos, Move m);
+// Finds the legal move matching a SAN string; check marks and !? annotations are ignored
+Move parseSan(Position& pos, const std::string& text);
+
+#endif
@@ -0,0 +1,81 @@
+#include "MoveValidation.h"
+#include "Attacks.h"
+#include "MoveGen.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 512 entries: 16 KB of positions, 1 KB of moves and 8 KB of results
+const size_t CHUNK_SIZE = 512;
+
+// A packed position comes from outside, so it needs exactly one king a side
+// (kingSquare is undefined otherwise) and the side that just moved must not be
+// left in check
+bool isSanePosition(const Position& pos) {
+    if (popCount(pos.pieces(makePiece(WHITE, KING))) != 1 || popCount(pos.pieces(makePiece(BLACK, KING))) != 1)
+        return false;
+    int them = pos.sideToMove() ^ 1;
+    return !pos.isSquareAttacked(pos.kingSquare(them), them ^ 1);
+}
+
+void validateRange(const PackedPosition* positions, const Move* moves, size_t begin, size_t end,
+                   ValidationResult* results) {
+    Position pos;
+    MoveList list;
+    for (size_t i = begin; i < end; ++i) {
+        ValidationResult& result = results[i];
+        result = ValidationResult{};
+        if (!isValidPacked(positions[i]))
+            continue;
+        unpackPosition(positions[i], pos);
+        if (!isSanePosition(pos))
+            continue;
+
+        list.count = 0;
+        generatePseudoLegalMoves(pos, list);
+        bool generated = false;
+        for (int j = 0; j < list.size() && !generated; ++j)
+            generated = list[j] == moves[i];
+        if (!generated)
+            continue;
+
+        int us = pos.sideToMove();
+        UndoInfo undo;
+        pos.makeMove(moves[i], undo);
+        if (!pos.isSquareAttacked(pos.kingSquare(us), us ^ 1)) {
+            result.legal = 1;
+            result.hash = pos.hash();
+        }
+    }
+}
+
+}
+
+void validateBatch(const PackedPosition* positions, const Move* moves, size_t count, ValidationResult* results,
+                   int threads) {
+    size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    if (threads > (int)chunks)
+        threads = (int)chunks;
+    if (threads <= 1) {
+        validateRange(positions, moves, 0, count, results);
+        return;
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            size_t begin = chunk * CHUNK_SIZE;
+            size_t end = begin + CHUNK_SIZE < count ? begin + CHUNK_SIZE : count;
+            validateRange(positions, moves, begin, end, results);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back(worker);
+    for (auto& t : pool)
+        t.join();
+}
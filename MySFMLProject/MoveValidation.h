@@ -0,0 +1,23 @@
+#ifndef MOVE_VALIDATION_H
+#define MOVE_VALIDATION_H
+
+#include "PackedPosition.h"
+#include <cstddef>
+
+struct ValidationResult {
+    uint64_t hash;      // Zobrist key after the move; 0 when the move is illegal
+    uint8_t legal;
+    uint8_t reserved[7];
+};
+
+// Checks moves[i] in positions[i] for every i < count and fills results[i].
+// The arrays are cut into chunks small enough that a chunk's positions, moves
+// and results stay in L1 while it is worked on; threads take chunks in turn.
+// threads 0 means one per hardware thread. A move only counts as legal if it
+// matches a generated move exactly, flags included. Positions that fail
+// isValidPacked, lack exactly one king a side or leave the side not to move in
+// check mark the move illegal.
+void validateBatch(const PackedPosition* positions, const Move* moves, size_t count, ValidationResult* results,
+                   int threads = 0);
+
+#endif
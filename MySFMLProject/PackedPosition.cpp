@@ -0,0 +1,49 @@
+#include "PackedPosition.h"
+#include "Attacks.h"
+
+PackedPosition packPosition(const Position& pos) {
+    PackedPosition packed = {};
+    packed.occupancy = pos.occupancy();
+
+    uint64_t occupied = packed.occupancy;
+    for (int i = 0; occupied; ++i) {
+        int piece = pos.pieceAt(popLsb(occupied));
+        packed.pieces[i / 2] |= (uint8_t)(piece << ((i % 2) * 4));
+    }
+
+    packed.sideAndCastling = (uint8_t)(pos.sideToMove() | (pos.castlingRights() << 1));
+    packed.epSquare = (int8_t)pos.enPassantSquare();
+    packed.halfmove = (uint16_t)pos.halfmoveClock();
+    packed.fullmove = (uint16_t)pos.fullmoveNumber();
+    return packed;
+}
+
+bool isValidPacked(const PackedPosition& packed) {
+    int count = popCount(packed.occupancy);
+    if (count > 32)
+        return false;
+    for (int i = 0; i < count; ++i) {
+        if (((packed.pieces[i / 2] >> ((i % 2) * 4)) & 15) >= NO_PIECE)
+            return false;
+    }
+    if ((packed.sideAndCastling >> 1) > 15)
+        return false;
+    if (packed.epSquare == -1)
+        return true;
+    // Square 0 is a8: white to move captures onto the sixth rank, black onto the third
+    int epRank = (packed.sideAndCastling & 1) == WHITE ? 2 : 5;
+    return packed.epSquare >= 0 && packed.epSquare / 8 == epRank;
+}
+
+void unpackPosition(const PackedPosition& packed, Position& pos) {
+    int8_t board[64];
+    for (int sq = 0; sq < 64; ++sq)
+        board[sq] = NO_PIECE;
+
+    uint64_t occupied = packed.occupancy;
+    for (int i = 0; occupied; ++i)
+        board[popLsb(occupied)] = (int8_t)((packed.pieces[i / 2] >> ((i % 2) * 4)) & 15);
+
+    pos.setup(board, packed.sideAndCastling & 1, packed.sideAndCastling >> 1, packed.epSquare,
+              packed.halfmove, packed.fullmove);
+}
@@ -0,0 +1,31 @@
+#ifndef PACKED_POSITION_H
+#define PACKED_POSITION_H
+
+#include "Position.h"
+#include <cstdint>
+
+// Fixed-size 32-byte snapshot of a Position for storing many of them at once.
+// Pieces are listed one nibble each, in square order, for the set bits of occupancy
+// (32 pieces at most). The hash history is not kept.
+struct PackedPosition {
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    uint8_t sideAndCastling;    // bit 0: side to move, bits 1-4: castling rights
+    int8_t epSquare;
+    uint16_t halfmove;
+    uint16_t fullmove;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay 32 bytes");
+
+PackedPosition packPosition(const Position& pos);
+void unpackPosition(const PackedPosition& packed, Position& pos);
+
+// Whether packed can be unpacked safely: at most 32 pieces, every listed piece a
+// real piece code, castling rights in 4 bits and the en passant square either -1
+// or on the rank behind a pawn that just made a double step. Check this before
+// unpacking a position that came from outside the program.
+bool isValidPacked(const PackedPosition& packed);
+
+#endif
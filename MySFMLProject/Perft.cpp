@@ -0,0 +1,199 @@
+// Perft: counts the leaf nodes of the legal move tree, to check the move
+// generator and to benchmark it.
+//
+// The last ply is bulk counted (the size of the legal move list, nothing is
+// made), and subtree counts are cached in a hash table keyed by Zobrist key and
+// remaining depth, so transpositions are counted once.
+//
+// Usage: perft [--fen FEN] [--depth 5] [--hash 64] [--divide]
+//        perft --suite [--depth-limit N] [--hash 64]   (known positions, exit code 1 on a mismatch)
+
+#include "MoveGen.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct PerftEntry {
+    uint64_t key;     // Zobrist key mixed with the depth, 0 when empty
+    uint64_t nodes;
+};
+
+// Always-replace cache of subtree sizes
+class PerftTable {
+public:
+    explicit PerftTable(int megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(PerftEntry) <= (size_t)megabytes * 1024 * 1024)
+            count *= 2;
+        entries.assign(megabytes > 0 ? count : 0, PerftEntry{0, 0});
+        mask = entries.empty() ? 0 : entries.size() - 1;
+    }
+
+    bool probe(uint64_t hash, int depth, uint64_t& nodes) const {
+        if (entries.empty())
+            return false;
+        uint64_t key = mix(hash, depth);
+        const PerftEntry& e = entries[key & mask];
+        if (e.key != key)
+            return false;
+        nodes = e.nodes;
+        return true;
+    }
+
+    void store(uint64_t hash, int depth, uint64_t nodes) {
+        if (entries.empty())
+            return;
+        uint64_t key = mix(hash, depth);
+        entries[key & mask] = PerftEntry{key, nodes};
+    }
+
+private:
+    std::vector<PerftEntry> entries;
+    size_t mask;
+
+    static uint64_t mix(uint64_t hash, int depth) { return hash ^ ((uint64_t)depth * 0x9E3779B97F4A7C15ULL); }
+};
+
+uint64_t perft(Position& pos, int depth, PerftTable& table) {
+    if (depth == 0)
+        return 1;
+
+    // A hit skips move generation entirely; depth 1 is cheaper to count than to look up
+    uint64_t cached;
+    if (depth > 1 && table.probe(pos.hash(), depth, cached))
+        return cached;
+
+    MoveList list;
+    generateLegalMoves(pos, list);
+    if (depth == 1)
+        return list.size();
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < list.size(); ++i) {
+        UndoInfo undo;
+        pos.makeMove(list[i], undo);
+        nodes += perft(pos, depth - 1, table);
+        pos.unmakeMove(list[i], undo);
+    }
+    table.store(pos.hash(), depth, nodes);
+    return nodes;
+}
+
+// Node count below each root move, for comparing against another engine
+uint64_t divide(Position& pos, int depth, PerftTable& table) {
+    MoveList list;
+    generateLegalMoves(pos, list);
+    uint64_t total = 0;
+    for (int i = 0; i < list.size(); ++i) {
+        UndoInfo undo;
+        pos.makeMove(list[i], undo);
+        uint64_t nodes = depth > 1 ? perft(pos, depth - 1, table) : 1;
+        pos.unmakeMove(list[i], undo);
+        std::cout << moveToString(list[i]) << ": " << nodes << std::endl;
+        total += nodes;
+    }
+    return total;
+}
+
+struct SuiteEntry {
+    const char* fen;
+    std::vector<uint64_t> counts;   // counts[d - 1] is perft(d)
+};
+
+const std::vector<SuiteEntry>& suite() {
+    static const std::vector<SuiteEntry> entries = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+         {20, 400, 8902, 197281, 4865609, 119060324}},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         {48, 2039, 97862, 4085603, 193690690}},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         {14, 191, 2812, 43238, 674624, 11030083}},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+         {6, 264, 9467, 422333, 15833292}},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+         {44, 1486, 62379, 2103487, 89941194}},
+    };
+    return entries;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int runSuite(int depthLimit, int hashMegabytes) {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const SuiteEntry& entry : suite()) {
+        Position pos;
+        pos.setFromFEN(entry.fen);
+        int depth = (int)entry.counts.size() < depthLimit ? (int)entry.counts.size() : depthLimit;
+        // A fresh table per position, so one entry cannot hide a bug in another
+        PerftTable table(hashMegabytes);
+        uint64_t nodes = perft(pos, depth, table);
+        uint64_t expected = entry.counts[depth - 1];
+        totalNodes += nodes;
+
+        bool ok = nodes == expected;
+        failures += ok ? 0 : 1;
+        std::cout << (ok ? "ok    " : "FAIL  ") << "depth " << depth << "  " << nodes;
+        if (!ok)
+            std::cout << " (expected " << expected << ")";
+        std::cout << "  " << entry.fen << std::endl;
+    }
+
+    double seconds = secondsSince(start);
+    std::cout << totalNodes << " nodes in " << seconds << " s";
+    if (seconds > 0)
+        std::cout << " (" << (uint64_t)(totalNodes / seconds) << " nps)";
+    std::cout << ", " << failures << " failed" << std::endl;
+    return failures ? 1 : 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    int depth = 5;
+    int depthLimit = 6;
+    int hashMegabytes = 64;
+    bool divideMode = false;
+    bool suiteMode = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--divide") divideMode = true;
+        else if (key == "--suite") suiteMode = true;
+        else if (i + 1 >= argc) std::cerr << "Missing value for " << key << std::endl;
+        else if (key == "--fen") fen = argv[++i];
+        else if (key == "--depth") depth = std::atoi(argv[++i]);
+        else if (key == "--depth-limit") depthLimit = std::atoi(argv[++i]);
+        else if (key == "--hash") hashMegabytes = std::atoi(argv[++i]);
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+
+    if (suiteMode)
+        return runSuite(depthLimit, hashMegabytes);
+
+    Position pos;
+    if (!pos.setFromFEN(fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 1;
+    }
+
+    PerftTable table(hashMegabytes);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = divideMode ? divide(pos, depth, table) : perft(pos, depth, table);
+    double seconds = secondsSince(start);
+
+    std::cout << "perft(" << depth << ") = " << nodes << "  " << seconds << " s";
+    if (seconds > 0)
+        std::cout << "  " << (uint64_t)(nodes / seconds) << " nps";
+    std::cout << std::endl;
+    return 0;
+}
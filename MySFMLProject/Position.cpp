@@ -0,0 +1,393 @@
+#include "Position.h"
+#include "Attacks.h"
+#include <sstream>
+
+namespace {
+
+struct ZobristKeys {
+    uint64_t pieceSquare[12][64] = {};
+    uint64_t castling[16] = {};
+    uint64_t epFile[8] = {};
+    uint64_t side = 0;
+
+    constexpr ZobristKeys() {
+        // Fixed seed so hashes are identical across runs and machines
+        uint64_t s = 0x9E3779B97F4A7C15ULL;
+        for (int p = 0; p < 12; ++p)
+            for (int sq = 0; sq < 64; ++sq)
+                pieceSquare[p][sq] = next(s);
+        for (int i = 0; i < 16; ++i)
+            castling[i] = next(s);
+        for (int f = 0; f < 8; ++f)
+            epFile[f] = next(s);
+        side = next(s);
+    }
+
+    static constexpr uint64_t next(uint64_t& s) {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1DULL;
+    }
+};
+
+// Generated at compile time like the attack tables
+constexpr ZobristKeys zobrist;
+
+// Rights that survive a move touching each square (king and rook home squares)
+int castlingMask(int sq) {
+    switch (sq) {
+        case 0:  return ~BLACK_OOO & 15;
+        case 4:  return ~(BLACK_OO | BLACK_OOO) & 15;
+        case 7:  return ~BLACK_OO & 15;
+        case 56: return ~WHITE_OOO & 15;
+        case 60: return ~(WHITE_OO | WHITE_OOO) & 15;
+        case 63: return ~WHITE_OO & 15;
+        default: return 15;
+    }
+}
+
+}
+
+int pieceFromName(const std::string& name) {
+    if (name.size() != 2)
+        return NO_PIECE;
+    int color = name[0] == 'w' ? WHITE : BLACK;
+    std::string types = "pnbrqk";
+    size_t type = types.find(name[1]);
+    if (type == std::string::npos)
+        return NO_PIECE;
+    return makePiece(color, (int)type);
+}
+
+std::string pieceName(int piece) {
+    if (piece == NO_PIECE)
+        return "";
+    std::string name;
+    name += pieceColor(piece) == WHITE ? 'w' : 'b';
+    name += "pnbrqk"[pieceType(piece)];
+    return name;
+}
+
+Position::Position() {
+    setStartPosition();
+}
+
+void Position::clear() {
+    for (int i = 0; i < 12; ++i)
+        pieceBB[i] = 0;
+    colorBB[WHITE] = colorBB[BLACK] = 0;
+    for (int sq = 0; sq < 64; ++sq)
+        squares[sq] = NO_PIECE;
+    side = WHITE;
+    castling = 0;
+    epSquare = -1;
+    halfmove = 0;
+    fullmove = 1;
+    key = 0;
+    historyTop = 0;
+    historyLength = 0;
+}
+
+void Position::setStartPosition() {
+    setFromFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+bool Position::setFromFEN(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, stm, rights, ep;
+    if (!(in >> placement >> stm >> rights >> ep))
+        return false;
+    int halfmoveField = 0, fullmoveField = 1;
+    in >> halfmoveField >> fullmoveField;
+
+    clear();
+    std::string letters = "PNBRQKpnbrqk";
+    int sq = 0;
+    for (char ch : placement) {
+        if (ch == '/')
+            continue;
+        if (ch >= '1' && ch <= '8') {
+            sq += ch - '0';
+        } else {
+            size_t piece = letters.find(ch);
+            if (piece == std::string::npos || sq >= 64)
+                return false;
+            putPiece((int)piece, sq++);
+        }
+    }
+    if (sq != 64)
+        return false;
+
+    side = stm == "b" ? BLACK : WHITE;
+    for (char ch : rights) {
+        if (ch == 'K') castling |= WHITE_OO;
+        if (ch == 'Q') castling |= WHITE_OOO;
+        if (ch == 'k') castling |= BLACK_OO;
+        if (ch == 'q') castling |= BLACK_OOO;
+    }
+    if (ep.size() == 2)
+        epSquare = ('8' - ep[1]) * 8 + (ep[0] - 'a');
+    halfmove = halfmoveField;
+    fullmove = fullmoveField;
+
+    key = computeHash();
+    return true;
+}
+
+void Position::setup(const int8_t* board, int sideToMove, int rights, int ep, int halfmoveClock, int fullmoveNumber) {
+    clear();
+    for (int sq = 0; sq < 64; ++sq)
+        if (board[sq] != NO_PIECE)
+            putPiece(board[sq], sq);
+    side = sideToMove;
+    castling = rights;
+    epSquare = ep;
+    halfmove = halfmoveClock;
+    fullmove = fullmoveNumber;
+    key = computeHash();
+}
+
+std::string Position::toFEN() const {
+    std::string letters = "PNBRQKpnbrqk";
+    std::string fen;
+    for (int row = 0; row < 8; ++row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            int piece = squares[row * 8 + col];
+            if (piece == NO_PIECE) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0)
+                fen += (char)('0' + empty);
+            empty = 0;
+            fen += letters[piece];
+        }
+        if (empty > 0)
+            fen += (char)('0' + empty);
+        if (row < 7)
+            fen += '/';
+    }
+
+    fen += side == WHITE ? " w " : " b ";
+    if (castling == 0)
+        fen += '-';
+    if (castling & WHITE_OO) fen += 'K';
+    if (castling & WHITE_OOO) fen += 'Q';
+    if (castling & BLACK_OO) fen += 'k';
+    if (castling & BLACK_OOO) fen += 'q';
+    fen += ' ';
+    fen += epSquare == -1 ? "-" : squareName(epSquare);
+    fen += " " + std::to_string(halfmove) + " " + std::to_string(fullmove);
+    return fen;
+}
+
+void Position::putPiece(int piece, int sq) {
+    uint64_t bit = 1ULL << sq;
+    pieceBB[piece] |= bit;
+    colorBB[pieceColor(piece)] |= bit;
+    squares[sq] = (int8_t)piece;
+    key ^= zobrist.pieceSquare[piece][sq];
+}
+
+void Position::removePiece(int sq) {
+    int piece = squares[sq];
+    uint64_t bit = 1ULL << sq;
+    pieceBB[piece] &= ~bit;
+    colorBB[pieceColor(piece)] &= ~bit;
+    squares[sq] = NO_PIECE;
+    key ^= zobrist.pieceSquare[piece][sq];
+}
+
+uint64_t Position::computeHash() const {
+    uint64_t h = 0;
+    for (int sq = 0; sq < 64; ++sq)
+        if (squares[sq] != NO_PIECE)
+            h ^= zobrist.pieceSquare[squares[sq]][sq];
+    h ^= zobrist.castling[castling];
+    if (epSquare != -1)
+        h ^= zobrist.epFile[epSquare % 8];
+    if (side == BLACK)
+        h ^= zobrist.side;
+    return h;
+}
+
+void Position::makeMove(Move m, UndoInfo& undo) {
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    int flags = moveFlags(m);
+    int piece = squares[from];
+    // White pawns travel towards row 0, so the captured en passant pawn sits one row below
+    int epVictim = side == WHITE ? to + 8 : to - 8;
+
+    undo.hash = key;
+    undo.halfmove = (int16_t)halfmove;
+    undo.castling = (uint8_t)castling;
+    undo.epSquare = (int8_t)epSquare;
+    undo.captured = (int8_t)(flags == EP_CAPTURE ? squares[epVictim] : squares[to]);
+
+    pushKey();
+    if (pieceType(piece) == PAWN || undo.captured != NO_PIECE)
+        halfmove = 0;
+    else
+        ++halfmove;
+    if (side == BLACK)
+        ++fullmove;
+
+    key ^= zobrist.castling[castling];
+    if (epSquare != -1)
+        key ^= zobrist.epFile[epSquare % 8];
+    epSquare = -1;
+
+    if (flags == EP_CAPTURE)
+        removePiece(epVictim);
+    else if (undo.captured != NO_PIECE)
+        removePiece(to);
+
+    removePiece(from);
+    putPiece(isPromotion(m) ? makePiece(side, promotionType(m)) : piece, to);
+
+    if (flags == KING_CASTLE) {
+        removePiece(to + 1);
+        putPiece(makePiece(side, ROOK), to - 1);
+    } else if (flags == QUEEN_CASTLE) {
+        removePiece(to - 2);
+        putPiece(makePiece(side, ROOK), to + 1);
+    } else if (flags == DOUBLE_PUSH) {
+        epSquare = (from + to) / 2;
+        key ^= zobrist.epFile[epSquare % 8];
+    }
+
+    castling &= castlingMask(from) & castlingMask(to);
+    key ^= zobrist.castling[castling];
+
+    side ^= 1;
+    key ^= zobrist.side;
+}
+
+void Position::unmakeMove(Move m, const UndoInfo& undo) {
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    int flags = moveFlags(m);
+
+    side ^= 1;
+    int piece = isPromotion(m) ? makePiece(side, PAWN) : squares[to];
+
+    if (flags == KING_CASTLE) {
+        removePiece(to - 1);
+        putPiece(makePiece(side, ROOK), to + 1);
+    } else if (flags == QUEEN_CASTLE) {
+        removePiece(to + 1);
+        putPiece(makePiece(side, ROOK), to - 2);
+    }
+
+    removePiece(to);
+    putPiece(piece, from);
+
+    if (flags == EP_CAPTURE)
+        putPiece(undo.captured, side == WHITE ? to + 8 : to - 8);
+    else if (undo.captured != NO_PIECE)
+        putPiece(undo.captured, to);
+
+    castling = undo.castling;
+    epSquare = undo.epSquare;
+    halfmove = undo.halfmove;
+    if (side == BLACK)
+        --fullmove;
+    key = undo.hash;
+    popKey();
+}
+
+void Position::makeNullMove(UndoInfo& undo) {
+    undo.hash = key;
+    undo.halfmove = (int16_t)halfmove;
+    undo.captured = NO_PIECE;
+    undo.castling = (uint8_t)castling;
+    undo.epSquare = (int8_t)epSquare;
+
+    pushKey();
+    // Repetitions across a null move are meaningless, so cut the scan off here
+    halfmove = 0;
+    if (epSquare != -1)
+        key ^= zobrist.epFile[epSquare % 8];
+    epSquare = -1;
+    side ^= 1;
+    key ^= zobrist.side;
+}
+
+void Position::unmakeNullMove(const UndoInfo& undo) {
+    side ^= 1;
+    halfmove = undo.halfmove;
+    epSquare = undo.epSquare;
+    key = undo.hash;
+    popKey();
+}
+
+int Position::kingSquare(int color) const {
+    uint64_t king = pieceBB[makePiece(color, KING)];
+    return king ? lsb(king) : -1;
+}
+
+bool Position::isSquareAttacked(int sq, int byColor) const {
+    if (sq < 0)
+        return false;
+    uint64_t occ = occupancy();
+    // A pawn of byColor attacks sq exactly when a pawn of the other colour on sq would attack it back
+    if (pawnAttacks(byColor ^ 1, sq) & pieceBB[makePiece(byColor, PAWN)])
+        return true;
+    if (knightAttacks(sq) & pieceBB[makePiece(byColor, KNIGHT)])
+        return true;
+    if (kingAttacks(sq) & pieceBB[makePiece(byColor, KING)])
+        return true;
+    uint64_t queens = pieceBB[makePiece(byColor, QUEEN)];
+    if (bishopAttacks(sq, occ) & (pieceBB[makePiece(byColor, BISHOP)] | queens))
+        return true;
+    if (rookAttacks(sq, occ) & (pieceBB[makePiece(byColor, ROOK)] | queens))
+        return true;
+    return false;
+}
+
+bool Position::hasInsufficientMaterial() const {
+    // Only kings plus at most one minor piece on the whole board
+    uint64_t heavy = 0;
+    for (int color = WHITE; color <= BLACK; ++color)
+        heavy |= pieceBB[makePiece(color, PAWN)] | pieceBB[makePiece(color, ROOK)] | pieceBB[makePiece(color, QUEEN)];
+    if (heavy)
+        return false;
+    uint64_t minors = pieceBB[makePiece(WHITE, KNIGHT)] | pieceBB[makePiece(WHITE, BISHOP)] |
+                      pieceBB[makePiece(BLACK, KNIGHT)] | pieceBB[makePiece(BLACK, BISHOP)];
+    return popCount(minors) <= 1;
+}
+
+void Position::pushKey() {
+    keyHistory[historyTop % KEY_HISTORY_SIZE] = key;
+    ++historyTop;
+    if (historyLength < KEY_HISTORY_SIZE)
+        ++historyLength;
+}
+
+void Position::popKey() {
+    --historyTop;
+    --historyLength;
+}
+
+// Counts earlier occurrences of the current key, stopping once stopAt are found
+int Position::repetitionsOfKey(int stopAt) const {
+    // Only positions since the last capture or pawn move can recur, and only those
+    // with the same side to move, so walk back two plies at a time
+    int limit = halfmove < historyLength ? halfmove : historyLength;
+    int count = 0;
+    for (int i = 4; i <= limit; i += 2)
+        if (keyHistory[(historyTop - i) % KEY_HISTORY_SIZE] == key && ++count == stopAt)
+            break;
+    return count;
+}
+
+bool Position::isRepetition() const {
+    return repetitionsOfKey(1) >= 1;
+}
+
+bool Position::isThreefoldRepetition() const {
+    return repetitionsOfKey(2) >= 2;
+}
@@ -0,0 +1,105 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "Move.h"
+#include <cstdint>
+#include <string>
+
+enum Color { WHITE = 0, BLACK = 1 };
+enum PieceType { PAWN = 0, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+// Piece codes are color * 6 + type, so white pawn is 0 and black king is 11
+const int NO_PIECE = 12;
+
+enum CastlingRight {
+    WHITE_OO = 1,
+    WHITE_OOO = 2,
+    BLACK_OO = 4,
+    BLACK_OOO = 8
+};
+
+inline int makePiece(int color, int type) { return color * 6 + type; }
+inline int pieceColor(int piece) { return piece / 6; }
+inline int pieceType(int piece) { return piece % 6; }
+
+// Converts between piece codes and the "wp"/"bk" names used by Board and the assets folder
+int pieceFromName(const std::string& name);
+std::string pieceName(int piece);
+
+// Everything makeMove needs to restore the previous position
+struct UndoInfo {
+    uint64_t hash;
+    int16_t halfmove;
+    int8_t captured;
+    uint8_t castling;
+    int8_t epSquare;
+};
+
+class Position {
+public:
+    Position();
+
+    void setStartPosition();
+    bool setFromFEN(const std::string& fen);
+    // Loads a position from a piece-per-square array (NO_PIECE for empty squares)
+    void setup(const int8_t* board, int sideToMove, int rights, int ep, int halfmoveClock, int fullmoveNumber);
+    std::string toFEN() const;
+
+    int pieceAt(int sq) const { return squares[sq]; }
+    int sideToMove() const { return side; }
+    int castlingRights() const { return castling; }
+    int enPassantSquare() const { return epSquare; }
+    uint64_t hash() const { return key; }
+    int halfmoveClock() const { return halfmove; }
+    int fullmoveNumber() const { return fullmove; }
+    uint64_t pieces(int piece) const { return pieceBB[piece]; }
+    uint64_t occupancy(int color) const { return colorBB[color]; }
+    uint64_t occupancy() const { return colorBB[WHITE] | colorBB[BLACK]; }
+    int kingSquare(int color) const;
+
+    bool isSquareAttacked(int sq, int byColor) const;
+    bool inCheck() const { return isSquareAttacked(kingSquare(side), side ^ 1); }
+    bool hasInsufficientMaterial() const;
+
+    void makeMove(Move m, UndoInfo& undo);
+    void unmakeMove(Move m, const UndoInfo& undo);
+    // Passes the turn; used by null-move pruning in search
+    void makeNullMove(UndoInfo& undo);
+    void unmakeNullMove(const UndoInfo& undo);
+
+    // Draw rules. isRepetition treats a single earlier occurrence as a draw, which is
+    // what search wants; games are only adjudicated on isThreefoldRepetition.
+    bool isRepetition() const;
+    bool isThreefoldRepetition() const;
+    bool isFiftyMoveDraw() const { return halfmove >= 100; }
+
+private:
+    uint64_t pieceBB[12];
+    uint64_t colorBB[2];
+    int8_t squares[64];
+    int side;
+    int castling;
+    int epSquare;
+    int halfmove;
+    int fullmove;
+    uint64_t key;
+    // Hashes of earlier positions as a ring, most recent at historyTop - 1. Only
+    // the last halfmove clock's worth can recur, and a game that reaches 100
+    // halfmoves is drawn anyway, so a fixed window keeps Position copies free of
+    // heap allocation.
+    static const int KEY_HISTORY_SIZE = 128;
+    uint64_t keyHistory[KEY_HISTORY_SIZE];
+    int historyTop;
+    int historyLength;
+
+    void pushKey();
+    void popKey();
+    int repetitionsOfKey(int stopAt) const;
+
+    void clear();
+    void putPiece(int piece, int sq);
+    void removePiece(int sq);
+    uint64_t computeHash() const;
+};
+
+#endif
@@ -0,0 +1,325 @@
+#include "PositionStore.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'P', 'O', 'S', 'D', 'B', '0', '0', '1'};
+
+struct FileHeader {
+    char magic[8];
+    uint64_t count;
+};
+
+void mergeInto(StoredResult& existing, const StoredResult& incoming) {
+    existing.visits += incoming.visits;
+    if (incoming.depth >= existing.depth) {
+        existing.bestMove = incoming.bestMove;
+        existing.score = incoming.score;
+        existing.depth = incoming.depth;
+    }
+}
+
+// Renames from over to in one step, so to is always either the old or the new file
+bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// Cuts a partial record left by a crash or a failed write off the end of a log,
+// so records appended after it stay aligned. A missing log is fine.
+bool trimToWholeRecords(const std::string& path) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return true;
+    uintmax_t whole = size - size % sizeof(StoredResult);
+    if (whole != size)
+        std::filesystem::resize_file(path, whole, error);
+    return !error;
+}
+
+// Appends the whole records of from to the end of to, then deletes from
+bool appendAndRemove(const std::string& from, const std::string& to) {
+    if (!trimToWholeRecords(from) || !trimToWholeRecords(to))
+        return false;
+    FILE* in = std::fopen(from.c_str(), "rb");
+    if (!in)
+        return true;   // nothing was logged yet
+    FILE* out = std::fopen(to.c_str(), "ab");
+    bool ok = out != nullptr;
+    char buffer[1 << 16];
+    size_t read;
+    while (ok && (read = std::fread(buffer, 1, sizeof(buffer), in)) > 0)
+        ok = std::fwrite(buffer, 1, read, out) == read;
+    ok = ok && !std::ferror(in);
+    std::fclose(in);
+    if (out && std::fclose(out) != 0)
+        ok = false;
+    return ok && std::remove(from.c_str()) == 0;
+}
+
+}
+
+PositionStore::PositionStore(const std::string& path, size_t compactThreshold)
+    : basePath(path), threshold(compactThreshold), records(nullptr), recordCount(0), deltaFile(nullptr),
+      compactRequested(false), compacting(false), shuttingDown(false) {
+    openBase();
+
+    // A leftover .delta.old means the last compaction never finished; redo it.
+    // A crash can leave half a record at the end of either log; drop it before
+    // anything is appended behind it.
+    std::string deltaPath = basePath + ".delta";
+    std::string oldPath = basePath + ".delta.old";
+    bool trimmed = trimToWholeRecords(oldPath) && trimToWholeRecords(deltaPath);
+    loadDelta(oldPath, frozen);
+    loadDelta(deltaPath, delta);
+    if (!frozen.empty())
+        compacting = compactRequested = true;
+
+    deltaFile = trimmed ? std::fopen(deltaPath.c_str(), "ab") : nullptr;
+    if (!deltaFile)
+        std::cerr << "Failed to open delta log: " << deltaPath << std::endl;
+
+    compactor = std::thread(&PositionStore::compactLoop, this);
+}
+
+PositionStore::~PositionStore() {
+    {
+        std::lock_guard<std::mutex> guard(compactMutex);
+        shuttingDown = true;
+    }
+    compactWake.notify_all();
+    compactor.join();
+    if (deltaFile)
+        std::fclose(deltaFile);
+}
+
+void PositionStore::openBase() {
+    records = nullptr;
+    recordCount = 0;
+    sparseIndex.clear();
+    if (!mapped.open(basePath + ".db") || mapped.size() < sizeof(FileHeader))
+        return;
+
+    const FileHeader* header = (const FileHeader*)mapped.data();
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        mapped.size() < sizeof(FileHeader) + header->count * sizeof(StoredResult)) {
+        std::cerr << "Ignoring corrupt position database: " << basePath << ".db" << std::endl;
+        mapped.close();
+        return;
+    }
+
+    records = (const StoredResult*)(mapped.data() + sizeof(FileHeader));
+    recordCount = header->count;
+    for (size_t i = 0; i < recordCount; i += INDEX_STRIDE)
+        sparseIndex.push_back(records[i].key);
+}
+
+bool PositionStore::findInBase(uint64_t key, StoredResult& result) const {
+    if (sparseIndex.empty())
+        return false;
+    // The RAM index narrows the search to one block; only that block touches the mapping
+    size_t block = std::upper_bound(sparseIndex.begin(), sparseIndex.end(), key) - sparseIndex.begin();
+    if (block == 0)
+        return false;
+    const StoredResult* begin = records + (block - 1) * INDEX_STRIDE;
+    const StoredResult* end = std::min(begin + INDEX_STRIDE, records + recordCount);
+    const StoredResult* found = std::lower_bound(begin, end, key,
+        [](const StoredResult& r, uint64_t k) { return r.key < k; });
+    if (found == end || found->key != key)
+        return false;
+    result = *found;
+    return true;
+}
+
+bool PositionStore::find(uint64_t key, StoredResult& result) const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    // Newer layers already include everything below them
+    auto it = delta.find(key);
+    if (it != delta.end()) {
+        result = it->second;
+        return true;
+    }
+    it = frozen.find(key);
+    if (it != frozen.end()) {
+        result = it->second;
+        return true;
+    }
+    return findInBase(key, result);
+}
+
+void PositionStore::put(const StoredResult& result) {
+    std::unique_lock<std::shared_mutex> guard(lock);
+
+    StoredResult merged = result;
+    StoredResult existing;
+    bool found = false;
+    auto it = delta.find(result.key);
+    if (it != delta.end()) {
+        existing = it->second;
+        found = true;
+    } else {
+        it = frozen.find(result.key);
+        if (it != frozen.end()) {
+            existing = it->second;
+            found = true;
+        } else {
+            found = findInBase(result.key, existing);
+        }
+    }
+    if (found) {
+        mergeInto(existing, result);
+        merged = existing;
+    }
+
+    delta[merged.key] = merged;
+    if (deltaFile && std::fwrite(&merged, sizeof(merged), 1, deltaFile) != 1) {
+        // Keep serving from memory; the next rotation tries the log again
+        std::cerr << "Failed to append to delta log: " << basePath << ".delta" << std::endl;
+        std::fclose(deltaFile);
+        deltaFile = nullptr;
+    }
+
+    if (delta.size() < threshold)
+        return;
+
+    std::lock_guard<std::mutex> compactGuard(compactMutex);
+    if (compacting)
+        return;
+
+    // Rotate the log: the current delta becomes frozen and is merged in the background.
+    // After a failed compaction frozen and .delta.old are still there, so the delta is
+    // added to them and the merge retried with both.
+    std::string deltaPath = basePath + ".delta";
+    std::string oldPath = basePath + ".delta.old";
+    bool logOpen = deltaFile != nullptr;
+    if (deltaFile)
+        std::fclose(deltaFile);
+    bool rotated = frozen.empty() ? !logOpen || replaceFile(deltaPath, oldPath)
+                                  : appendAndRemove(deltaPath, oldPath);
+    // A log left in place after a failed write may end in half a record
+    deltaFile = trimToWholeRecords(deltaPath) ? std::fopen(deltaPath.c_str(), "ab") : nullptr;
+    if (!rotated) {
+        std::cerr << "Failed to rotate delta log: " << deltaPath << std::endl;
+        return;
+    }
+    if (frozen.empty()) {
+        frozen.swap(delta);
+    } else {
+        // Delta records already include what frozen had for the same key
+        for (const auto& entry : delta)
+            frozen[entry.first] = entry.second;
+        delta.clear();
+    }
+
+    compacting = compactRequested = true;
+    compactWake.notify_all();
+}
+
+void PositionStore::flush() {
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        if (deltaFile)
+            std::fflush(deltaFile);
+    }
+    std::unique_lock<std::mutex> guard(compactMutex);
+    compactWake.wait(guard, [this] { return !compacting; });
+}
+
+void PositionStore::loadDelta(const std::string& file, std::unordered_map<uint64_t, StoredResult>& into) {
+    FILE* in = std::fopen(file.c_str(), "rb");
+    if (!in)
+        return;
+    // Each logged record is already merged, so the last one for a key wins
+    StoredResult record;
+    while (std::fread(&record, sizeof(record), 1, in) == 1)
+        into[record.key] = record;
+    std::fclose(in);
+}
+
+void PositionStore::compactLoop() {
+    std::unique_lock<std::mutex> guard(compactMutex);
+    for (;;) {
+        compactWake.wait(guard, [this] { return compactRequested || shuttingDown; });
+        if (compactRequested) {
+            compactRequested = false;
+            guard.unlock();
+            if (!compact())
+                std::cerr << "Compaction failed; retrying at the next rotation" << std::endl;
+            guard.lock();
+            compacting = false;
+            compactWake.notify_all();
+        } else {
+            return;
+        }
+    }
+}
+
+bool PositionStore::compact() {
+    // Nothing else modifies the base mapping or the frozen map while we run,
+    // so they are read without holding the lock
+    std::vector<StoredResult> fresh;
+    fresh.reserve(frozen.size());
+    for (const auto& entry : frozen)
+        fresh.push_back(entry.second);
+    std::sort(fresh.begin(), fresh.end(),
+        [](const StoredResult& a, const StoredResult& b) { return a.key < b.key; });
+
+    std::string tmpPath = basePath + ".db.tmp";
+    FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Failed to write position database: " << tmpPath << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.count = 0;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+
+    size_t i = 0, j = 0;
+    while (ok && (i < recordCount || j < fresh.size())) {
+        if (j == fresh.size() || (i < recordCount && records[i].key < fresh[j].key)) {
+            ok = std::fwrite(&records[i++], sizeof(StoredResult), 1, out) == 1;
+        } else {
+            if (i < recordCount && records[i].key == fresh[j].key)
+                ++i;
+            ok = std::fwrite(&fresh[j++], sizeof(StoredResult), 1, out) == 1;
+        }
+        ++header.count;
+    }
+
+    ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, out) == 1;
+    if (std::fclose(out) != 0)
+        ok = false;
+    if (!ok) {
+        std::cerr << "Failed to write position database: " << tmpPath << std::endl;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // The old .db stays in place until the new one replaces it, so a crash leaves
+    // either of them plus .delta.old, and startup redoes the merge
+    std::unique_lock<std::shared_mutex> guard(lock);
+    mapped.close();
+    if (!replaceFile(tmpPath, basePath + ".db")) {
+        std::cerr << "Failed to replace position database: " << basePath << ".db" << std::endl;
+        openBase();
+        return false;
+    }
+    openBase();
+    frozen.clear();
+    std::remove((basePath + ".delta.old").c_str());
+    return true;
+}
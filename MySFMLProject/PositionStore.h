@@ -0,0 +1,75 @@
+#ifndef POSITION_STORE_H
+#define POSITION_STORE_H
+
+#include "MappedFile.h"
+#include "Move.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One analysed position, keyed by its Zobrist hash
+struct StoredResult {
+    uint64_t key;
+    uint32_t visits;
+    Move bestMove;
+    int16_t score;
+    uint8_t depth;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(StoredResult) == 24, "StoredResult is written to disk as is");
+
+// Persistent analysis cache. Results live in three places:
+//   <path>.db        sorted records, memory-mapped, with every 64th key kept in RAM
+//   <path>.delta     append-only log of new results, also held in a hash map
+//   <path>.delta.old a delta being merged into a new .db by the background thread
+// Once the delta grows past a threshold it is rotated and compacted in the background,
+// so put() never waits for a merge. Safe to use from several threads.
+class PositionStore {
+public:
+    explicit PositionStore(const std::string& path, size_t compactThreshold = 1 << 20);
+    ~PositionStore();
+
+    bool find(uint64_t key, StoredResult& result) const;
+    // Merges with any stored result: visits add up and the deeper analysis wins
+    void put(const StoredResult& result);
+    // Flushes the delta log and waits for a running compaction
+    void flush();
+
+private:
+    static const int INDEX_STRIDE = 64;
+
+    std::string basePath;
+    size_t threshold;
+
+    MappedFile mapped;
+    const StoredResult* records;
+    size_t recordCount;
+    std::vector<uint64_t> sparseIndex;
+
+    std::unordered_map<uint64_t, StoredResult> delta;
+    std::unordered_map<uint64_t, StoredResult> frozen;
+    FILE* deltaFile;
+
+    mutable std::shared_mutex lock;
+    std::thread compactor;
+    std::mutex compactMutex;
+    std::condition_variable compactWake;
+    bool compactRequested;
+    bool compacting;
+    bool shuttingDown;
+
+    void openBase();
+    bool findInBase(uint64_t key, StoredResult& result) const;
+    void loadDelta(const std::string& file, std::unordered_map<uint64_t, StoredResult>& into);
+    void compactLoop();
+    // Writes base + frozen to a new .db; on failure frozen and .delta.old stay for a retry
+    bool compact();
+};
+
+#endif
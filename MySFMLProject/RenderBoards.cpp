@@ -0,0 +1,118 @@
+// Batch board-diagram export without a window: one PNG per FEN.
+//
+// Reads one FEN per line and writes <out>/<line number>.png (zero padded),
+// rendering on all cores with a shared BoardRenderer. The out directory is
+// created if it does not exist; blank lines are skipped and not counted.
+//
+// Usage: renderboards positions.fen [--out thumbnails] [--size 32] [--threads N] [--assets assets]
+
+#include "BoardRenderer.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Creates dir (one level) unless it is already there
+static bool makeDirectory(const std::string& dir) {
+#ifdef _WIN32
+    int rc = _mkdir(dir.c_str());
+#else
+    int rc = mkdir(dir.c_str(), 0777);
+#endif
+    return rc == 0 || errno == EEXIST;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: renderboards positions.fen [--out dir] [--size px] [--threads N] [--assets dir]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string inFile = argv[1];
+    std::string outDir = "thumbnails";
+    std::string assetDir = "assets";
+    int tileSize = 32;
+    int threads = (int)std::thread::hardware_concurrency();
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--out") outDir = value;
+        else if (key == "--size") tileSize = std::atoi(value.c_str());
+        else if (key == "--threads") threads = std::atoi(value.c_str());
+        else if (key == "--assets") assetDir = value;
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+    if (threads < 1)
+        threads = 1;
+    if (tileSize < 1)
+        tileSize = 1;
+
+    std::ifstream in(inFile);
+    if (!in) {
+        std::cerr << "Failed to open " << inFile << std::endl;
+        return 1;
+    }
+    std::vector<std::string> fens;
+    std::string line;
+    size_t positions = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty())
+            ++positions;
+        fens.push_back(line);
+    }
+
+    if (!makeDirectory(outDir)) {
+        std::cerr << "Failed to create output directory " << outDir << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    BoardRenderer renderer;
+    if (!renderer.loadPieces(assetDir))
+        return 1;
+
+    std::atomic<size_t> next(0);
+    std::atomic<int> failures(0);
+    std::atomic<int> rendered(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            sf::Image image;
+            Position pos;
+            for (size_t i = next++; i < fens.size(); i = next++) {
+                if (fens[i].empty())
+                    continue;
+                if (!pos.setFromFEN(fens[i])) {
+                    std::cerr << "Invalid FEN on line " << i + 1 << ": " << fens[i] << std::endl;
+                    ++failures;
+                    continue;
+                }
+                renderer.render(pos, tileSize, image);
+
+                char name[32];
+                std::snprintf(name, sizeof(name), "/%06zu.png", i + 1);
+                if (image.saveToFile(outDir + name))
+                    ++rendered;
+                else
+                    ++failures;
+            }
+        });
+    }
+    for (auto& t : pool)
+        t.join();
+
+    std::cout << "Rendered " << rendered << " of " << positions << " positions" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,420 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+const int PIECE_VALUE[6] = {100, 320, 330, 500, 900, 20000};
+
+// Mate scores are stored relative to the node, not the root
+int scoreToTT(int score, int ply) {
+    if (score > MATE_SCORE - MAX_PLY) return score + ply;
+    if (score < -MATE_SCORE + MAX_PLY) return score - ply;
+    return score;
+}
+
+int scoreFromTT(int score, int ply) {
+    if (score > MATE_SCORE - MAX_PLY) return score - ply;
+    if (score < -MATE_SCORE + MAX_PLY) return score + ply;
+    return score;
+}
+
+// Moves the highest-scored remaining move to index i (lazy selection sort)
+void pickMove(Move* moves, int* scores, int count, int i) {
+    int best = i;
+    for (int j = i + 1; j < count; ++j)
+        if (scores[j] > scores[best])
+            best = j;
+    std::swap(moves[i], moves[best]);
+    std::swap(scores[i], scores[best]);
+}
+
+bool hasNonPawnMaterial(const Position& pos, int color) {
+    return pos.occupancy(color) != (pos.pieces(makePiece(color, PAWN)) | pos.pieces(makePiece(color, KING)));
+}
+
+}
+
+void SearchStats::add(const SearchStats& other) {
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCutoffs += other.ttCutoffs;
+    for (int i = 0; i < CUTOFF_SLOTS; ++i)
+        betaCutoffs[i] += other.betaCutoffs[i];
+    nullMoveTries += other.nullMoveTries;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    lmrReductions += other.lmrReductions;
+    lmrResearches += other.lmrResearches;
+    evalCalls += other.evalCalls;
+}
+
+std::string SearchStats::report() const {
+    auto percent = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+    uint64_t cutoffs = 0;
+    for (int i = 0; i < CUTOFF_SLOTS; ++i)
+        cutoffs += betaCutoffs[i];
+
+    char buffer[640];
+    std::snprintf(buffer, sizeof(buffer),
+        "nodes %llu, qnodes %llu (%.1f%%), eval calls %llu\n"
+        "tt probes %llu, hits %.1f%%, cutoffs %llu\n"
+        "beta cutoffs %llu: 1st move %.1f%%, 2nd %.1f%%, 3rd %.1f%%, later %.1f%%\n"
+        "null move tries %llu, cutoffs %.1f%%\n"
+        "lmr reductions %llu, re-searched %.1f%%\n",
+        (unsigned long long)nodes, (unsigned long long)qnodes, percent(qnodes, nodes + qnodes),
+        (unsigned long long)evalCalls, (unsigned long long)ttProbes, percent(ttHits, ttProbes),
+        (unsigned long long)ttCutoffs, (unsigned long long)cutoffs, percent(betaCutoffs[0], cutoffs),
+        percent(betaCutoffs[1], cutoffs), percent(betaCutoffs[2], cutoffs),
+        percent(cutoffs - betaCutoffs[0] - betaCutoffs[1] - betaCutoffs[2], cutoffs),
+        (unsigned long long)nullMoveTries, percent(nullMoveCutoffs, nullMoveTries),
+        (unsigned long long)lmrReductions, percent(lmrResearches, lmrReductions));
+    return buffer;
+}
+
+Search::Search(int hashMegabytes)
+    : tt(hashMegabytes), stopRequested(false), stopPending(false), pondering(false), ponderTimeMs(0), trace(nullptr) {
+    clear();
+}
+
+void Search::clear() {
+    tt.clear();
+    for (int ply = 0; ply < MAX_PLY; ++ply)
+        killers[ply][0] = killers[ply][1] = NULL_MOVE;
+    for (int piece = 0; piece < 12; ++piece)
+        for (int sq = 0; sq < 64; ++sq)
+            history[piece][sq] = 0;
+}
+
+int Search::elapsedMs() const {
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Search::ponderHit() {
+    ponderTimeMs = elapsedMs();
+    pondering = false;
+}
+
+void Search::checkLimits() {
+    uint64_t nodes = nodeCount();
+    if (limits.nodes && nodes >= limits.nodes)
+        stopRequested = true;
+    if ((nodes & 1023) != 0 || pondering)
+        return;
+    if (limits.moveTimeMs && clockMs() >= limits.moveTimeMs)
+        stopRequested = true;
+    if (limits.timeLeftMs && clockMs() >= timeManager.hardLimitMs())
+        stopRequested = true;
+}
+
+bool Search::isExcludedRootMove(Move m) const {
+    return std::find(excludedRootMoves.begin(), excludedRootMoves.end(), m) != excludedRootMoves.end();
+}
+
+int Search::evaluatePosition(const Position& pos) {
+    ++stats.evalCalls;
+    return evaluate(pos);
+}
+
+SearchResult Search::think(Position& pos, const SearchLimits& searchLimits) {
+    limits = searchLimits;
+    startTime = std::chrono::steady_clock::now();
+    // Clear the flag before looking at stopPending, so a concurrent stop() always sticks
+    stopRequested = false;
+    if (stopPending)
+        stopRequested = true;
+    pondering = limits.ponder;
+    ponderTimeMs = 0;
+    stats = SearchStats();
+    if (limits.timeLeftMs) {
+        TimeControl control;
+        control.timeLeftMs = limits.timeLeftMs;
+        control.incrementMs = limits.incrementMs;
+        control.movesToGo = limits.movesToGo;
+        timeManager.start(control);
+    }
+    int stableIterations = 0;
+
+    for (int ply = 0; ply < MAX_PLY; ++ply)
+        killers[ply][0] = killers[ply][1] = NULL_MOVE;
+
+    SearchResult result;
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    if (legal.size() > 0)
+        result.bestMove = legal[0];
+    int lineCount = limits.multiPV < legal.size() ? limits.multiPV : legal.size();
+    if (lineCount < 1)
+        lineCount = 1;
+
+    for (int depth = 1; depth <= limits.depth; ++depth) {
+        // Each further line searches the root again without the moves of the lines
+        // before it; everything below the root is shared through the TT and history
+        std::vector<SearchLine> lines;
+        excludedRootMoves.clear();
+        for (int pvIndex = 0; pvIndex < lineCount; ++pvIndex) {
+            SearchLine line;
+            line.score = negamax(pos, depth, -INFINITE_SCORE, INFINITE_SCORE, 0, false);
+            if (stopRequested)
+                break;
+            line.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+            if (line.pv.empty())
+                break;
+            excludedRootMoves.push_back(line.pv[0]);
+            lines.push_back(line);
+        }
+        excludedRootMoves.clear();
+        // An interrupted iteration is dropped unless it is all we have
+        if ((stopRequested && depth > 1) || lines.empty())
+            break;
+
+        std::stable_sort(lines.begin(), lines.end(),
+                         [](const SearchLine& a, const SearchLine& b) { return a.score > b.score; });
+        int score = lines[0].score;
+        int scoreDrop = depth > 1 ? result.score - score : 0;
+        stableIterations = depth > 1 && lines[0].pv[0] == result.bestMove ? stableIterations + 1 : 0;
+        result.depth = depth;
+        result.score = score;
+        result.pv = lines[0].pv;
+        result.bestMove = result.pv[0];
+        result.lines = lines;
+        if (trace)
+            trace->record(EVENT_ITERATION, depth, 0, result.bestMove, score, 0, nodeCount());
+
+        if (stopRequested)
+            break;
+        if (!pondering) {
+            // A new iteration takes longer than all previous ones together
+            if (limits.moveTimeMs && clockMs() * 2 >= limits.moveTimeMs)
+                break;
+            if (limits.timeLeftMs && timeManager.shouldStop(clockMs(), stableIterations, scoreDrop))
+                break;
+        }
+        // A proven mate ends the search, unless other lines still need their depth
+        if (lineCount == 1 && isMateScore(score) && MATE_SCORE - (score > 0 ? score : -score) <= depth)
+            break;
+    }
+
+    result.nodes = nodeCount();
+    result.timeMs = elapsedMs();
+    result.stats = stats;
+    return result;
+}
+
+void Search::scoreMoves(const Position& pos, const Move* moves, int* scores, int count, Move ttMove, int ply) const {
+    for (int i = 0; i < count; ++i) {
+        Move m = moves[i];
+        if (m == ttMove) {
+            scores[i] = 1000000;
+        } else if (isCapture(m)) {
+            int victim = moveFlags(m) == EP_CAPTURE ? PAWN : pieceType(pos.pieceAt(moveTo(m)));
+            int attacker = pieceType(pos.pieceAt(moveFrom(m)));
+            scores[i] = 100000 + PIECE_VALUE[victim] * 10 - PIECE_VALUE[attacker] / 10;
+        } else if (isPromotion(m)) {
+            scores[i] = 95000 + promotionType(m);
+        } else if (m == killers[ply][0]) {
+            scores[i] = 90000;
+        } else if (m == killers[ply][1]) {
+            scores[i] = 89000;
+        } else {
+            scores[i] = history[pos.pieceAt(moveFrom(m))][moveTo(m)];
+        }
+    }
+}
+
+int Search::negamax(Position& pos, int depth, int alpha, int beta, int ply, bool allowNull) {
+    pvLength[ply] = ply;
+    if (depth <= 0)
+        return quiescence(pos, alpha, beta, ply);
+
+    ++stats.nodes;
+    checkLimits();
+    if (stopRequested)
+        return 0;
+
+    bool rootNode = ply == 0;
+    bool pvNode = beta - alpha > 1;
+    if (!rootNode) {
+        if (pos.isRepetition() || pos.isFiftyMoveDraw() || pos.hasInsufficientMaterial())
+            return 0;
+        if (ply >= MAX_PLY - 1)
+            return evaluatePosition(pos);
+    }
+
+    bool inCheck = pos.inCheck();
+    if (inCheck)
+        ++depth;
+
+    Move ttMove = NULL_MOVE;
+    ++stats.ttProbes;
+    const TTEntry* entry = tt.probe(pos.hash());
+    if (entry) {
+        ++stats.ttHits;
+        ttMove = entry->move;
+        int ttScore = scoreFromTT(entry->score, ply);
+        if (!pvNode && entry->depth >= depth &&
+            (entry->bound == BOUND_EXACT || (entry->bound == BOUND_LOWER && ttScore >= beta) ||
+             (entry->bound == BOUND_UPPER && ttScore <= alpha))) {
+            ++stats.ttCutoffs;
+            if (trace)
+                trace->record(EVENT_TT_CUTOFF, depth, ply, ttMove, ttScore, 0, nodeCount());
+            return ttScore;
+        }
+    }
+
+    // Null move: if passing still fails high, a real move almost certainly would too
+    if (params.nullMove && allowNull && !pvNode && !inCheck && depth >= 3 && hasNonPawnMaterial(pos, pos.sideToMove()) &&
+        evaluatePosition(pos) >= beta) {
+        ++stats.nullMoveTries;
+        int reduction = params.nullMoveReduction + depth / 4;
+        UndoInfo undo;
+        pos.makeNullMove(undo);
+        int score = -negamax(pos, depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+        pos.unmakeNullMove(undo);
+        if (stopRequested)
+            return 0;
+        if (score >= beta && !isMateScore(score)) {
+            ++stats.nullMoveCutoffs;
+            if (trace)
+                trace->record(EVENT_NULL_CUTOFF, depth, ply, NULL_MOVE, score, 0, nodeCount());
+            return beta;
+        }
+    }
+
+    MoveList list;
+    generatePseudoLegalMoves(pos, list);
+    int scores[256];
+    scoreMoves(pos, list.moves, scores, list.size(), ttMove, ply);
+
+    int us = pos.sideToMove();
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove = NULL_MOVE;
+    int originalAlpha = alpha;
+    int legalMoves = 0;
+
+    for (int i = 0; i < list.size(); ++i) {
+        pickMove(list.moves, scores, list.size(), i);
+        Move m = list[i];
+        if (rootNode && isExcludedRootMove(m))
+            continue;
+
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        if (pos.isSquareAttacked(pos.kingSquare(us), us ^ 1)) {
+            pos.unmakeMove(m, undo);
+            continue;
+        }
+        ++legalMoves;
+
+        bool quiet = !isCapture(m) && !isPromotion(m);
+        int score;
+        if (legalMoves == 1) {
+            score = -negamax(pos, depth - 1, -beta, -alpha, ply + 1, true);
+        } else {
+            // Late quiet moves are searched shallower first and only re-searched if they surprise
+            int reduction = 0;
+            if (params.lateMoveReductions && depth >= 3 && legalMoves > params.lmrFullDepthMoves && quiet &&
+                !inCheck && !pos.inCheck())
+                reduction = legalMoves > 8 ? 2 : 1;
+
+            if (reduction > 0)
+                ++stats.lmrReductions;
+
+            score = -negamax(pos, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && reduction > 0) {
+                ++stats.lmrResearches;
+                if (trace)
+                    trace->record(EVENT_LMR_RESEARCH, depth, ply, m, score, reduction, nodeCount());
+                score = -negamax(pos, depth - 1, -alpha - 1, -alpha, ply + 1, true);
+            }
+            if (score > alpha && score < beta)
+                score = -negamax(pos, depth - 1, -beta, -alpha, ply + 1, true);
+        }
+        pos.unmakeMove(m, undo);
+
+        if (stopRequested)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = m;
+            if (score > alpha) {
+                alpha = score;
+                pvTable[ply][ply] = m;
+                for (int next = ply + 1; next < pvLength[ply + 1]; ++next)
+                    pvTable[ply][next] = pvTable[ply + 1][next];
+                pvLength[ply] = pvLength[ply + 1];
+            }
+        }
+
+        if (alpha >= beta) {
+            int slot = legalMoves - 1 < SearchStats::CUTOFF_SLOTS ? legalMoves - 1 : SearchStats::CUTOFF_SLOTS - 1;
+            ++stats.betaCutoffs[slot];
+            if (trace)
+                trace->record(EVENT_BETA_CUTOFF, depth, ply, m, score, legalMoves - 1, nodeCount());
+            if (quiet) {
+                if (killers[ply][0] != m) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = m;
+                }
+                history[pos.pieceAt(moveFrom(m))][moveTo(m)] += depth * depth;
+            }
+            break;
+        }
+    }
+
+    if (legalMoves == 0)
+        return inCheck ? -MATE_SCORE + ply : 0;
+
+    // A root searched without some of its moves must not pose as the real root score
+    if (!rootNode || excludedRootMoves.empty()) {
+        int bound = bestScore >= beta ? BOUND_LOWER : (alpha > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+        tt.store(pos.hash(), bestMove, scoreToTT(bestScore, ply), depth, bound);
+    }
+    return bestScore;
+}
+
+int Search::quiescence(Position& pos, int alpha, int beta, int ply) {
+    ++stats.qnodes;
+    checkLimits();
+    if (stopRequested)
+        return 0;
+
+    int standPat = evaluatePosition(pos);
+    if (ply >= MAX_PLY - 1 || standPat >= beta)
+        return standPat;
+    if (standPat > alpha)
+        alpha = standPat;
+
+    MoveList list;
+    generateCaptures(pos, list);
+    int scores[256];
+    scoreMoves(pos, list.moves, scores, list.size(), NULL_MOVE, ply);
+
+    int us = pos.sideToMove();
+    for (int i = 0; i < list.size(); ++i) {
+        pickMove(list.moves, scores, list.size(), i);
+        Move m = list[i];
+
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        if (pos.isSquareAttacked(pos.kingSquare(us), us ^ 1)) {
+            pos.unmakeMove(m, undo);
+            continue;
+        }
+        int score = -quiescence(pos, -beta, -alpha, ply + 1);
+        pos.unmakeMove(m, undo);
+
+        if (stopRequested)
+            return 0;
+        if (score >= beta)
+            return score;
+        if (score > alpha)
+            alpha = score;
+    }
+    return alpha;
+}
@@ -0,0 +1,138 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "Position.h"
+#include "SearchTrace.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+const int MAX_PLY = 128;
+const int MATE_SCORE = 32000;
+const int INFINITE_SCORE = 32001;
+
+inline bool isMateScore(int score) {
+    return score > MATE_SCORE - MAX_PLY || score < -MATE_SCORE + MAX_PLY;
+}
+
+struct SearchLimits {
+    int depth = MAX_PLY - 1;
+    int moveTimeMs = 0;   // 0 means no time limit
+    uint64_t nodes = 0;   // 0 means no node limit
+    int multiPV = 1;      // number of best root moves to report, each with its own line
+    // Clock-based budgeting, used when timeLeftMs is set (see TimeManager)
+    int timeLeftMs = 0;
+    int incrementMs = 0;
+    int movesToGo = 0;
+    // Search on the opponent's time with no time limit until ponderHit() or stop()
+    bool ponder = false;
+};
+
+// Counters for one search, kept per Search instance so threads never share them
+struct SearchStats {
+    // Beta cutoffs by index of the cutting move; the last slot collects the rest
+    static const int CUTOFF_SLOTS = 8;
+
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t ttCutoffs = 0;
+    uint64_t betaCutoffs[CUTOFF_SLOTS] = {};
+    uint64_t nullMoveTries = 0;
+    uint64_t nullMoveCutoffs = 0;
+    uint64_t lmrReductions = 0;
+    uint64_t lmrResearches = 0;
+    uint64_t evalCalls = 0;
+
+    void add(const SearchStats& other);
+    // Human-readable summary, one line per group of counters
+    std::string report() const;
+};
+
+// Search heuristics that two engine configurations may want to compare; the
+// defaults are what the engine normally plays with
+struct SearchParams {
+    bool nullMove = true;
+    int nullMoveReduction = 2;     // depth / 4 is added on top
+    bool lateMoveReductions = true;
+    int lmrFullDepthMoves = 3;     // moves searched at full depth before reducing
+};
+
+// One principal variation, starting with a distinct root move
+struct SearchLine {
+    int score = 0;
+    std::vector<Move> pv;
+};
+
+struct SearchResult {
+    Move bestMove = NULL_MOVE;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int timeMs = 0;
+    std::vector<Move> pv;
+    // Best line first; lines[0] repeats score and pv. Holds min(multiPV, legal moves) lines.
+    std::vector<SearchLine> lines;
+    SearchStats stats;
+};
+
+// Iterative deepening alpha-beta searcher. One instance per thread; the
+// transposition table, killers and history belong to the instance.
+class Search {
+public:
+    explicit Search(int hashMegabytes = 16);
+
+    SearchResult think(Position& pos, const SearchLimits& limits);
+    // Safe to call from another thread while think() is running. A stop that
+    // arrives before think() has started is kept and ends that search at once;
+    // clearStop() drops it, so call it before starting the next search.
+    void stop() {
+        stopPending = true;
+        stopRequested = true;
+    }
+    void clearStop() { stopPending = false; }
+    // The opponent played the predicted move: keep searching, now on our own clock
+    void ponderHit();
+    // Forget everything learned from the previous game
+    void clear();
+    // Records search events into trace until set back to nullptr
+    void setTrace(SearchTrace* searchTrace) { trace = searchTrace; }
+    void setParams(const SearchParams& searchParams) { params = searchParams; }
+
+private:
+    TranspositionTable tt;
+    Move killers[MAX_PLY][2];
+    int history[12][64];
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+
+    SearchLimits limits;
+    SearchParams params;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> stopPending;   // stop() was called since the last clearStop()
+    TimeManager timeManager;
+    std::atomic<bool> pondering;
+    // Time spent pondering before the ponder hit, which is not charged to our clock
+    std::atomic<int> ponderTimeMs;
+    SearchStats stats;
+    SearchTrace* trace;
+    // Root moves already reported as a better line in this iteration
+    std::vector<Move> excludedRootMoves;
+
+    int negamax(Position& pos, int depth, int alpha, int beta, int ply, bool allowNull);
+    int quiescence(Position& pos, int alpha, int beta, int ply);
+    void checkLimits();
+    int elapsedMs() const;
+    int clockMs() const { return elapsedMs() - ponderTimeMs; }
+    uint64_t nodeCount() const { return stats.nodes + stats.qnodes; }
+    int evaluatePosition(const Position& pos);
+    bool isExcludedRootMove(Move m) const;
+    void scoreMoves(const Position& pos, const Move* moves, int* scores, int count, Move ttMove, int ply) const;
+};
+
+#endif
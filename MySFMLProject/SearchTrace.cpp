@@ -0,0 +1,30 @@
+#include "SearchTrace.h"
+#include <cstdio>
+#include <iostream>
+
+SearchTrace::SearchTrace(size_t capacity) : head(0) {
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    events.resize(size);
+    mask = size - 1;
+}
+
+bool SearchTrace::dump(const std::string& path) const {
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Failed to write search trace: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t count = (uint32_t)size();
+    std::fwrite("STRC", 1, 4, out);
+    std::fwrite(&count, sizeof(count), 1, out);
+
+    uint64_t first = head - count;
+    for (uint64_t i = first; i < head; ++i)
+        std::fwrite(&events[i & mask], sizeof(SearchEvent), 1, out);
+
+    std::fclose(out);
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include "Move.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum SearchEventType : uint8_t {
+    EVENT_ITERATION = 0,    // an iteration finished: value is the score, nodes the node count
+    EVENT_BETA_CUTOFF = 1,  // extra holds the index of the cutting move
+    EVENT_TT_CUTOFF = 2,
+    EVENT_NULL_CUTOFF = 3,
+    EVENT_LMR_RESEARCH = 4  // a reduced move beat alpha and was searched again at full depth
+};
+
+// 16 bytes per event, written to disk exactly like this
+struct SearchEvent {
+    uint32_t nodes;
+    int16_t value;
+    Move move;
+    uint8_t type;
+    uint8_t depth;
+    uint8_t ply;
+    uint8_t extra;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SearchEvent) == 16, "SearchEvent is dumped as raw bytes");
+
+// Fixed-size ring of the most recent search events. Recording never allocates;
+// once full the oldest events are overwritten.
+class SearchTrace {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SearchTrace(size_t capacity = 1 << 16);
+
+    void record(uint8_t type, int depth, int ply, Move move, int value, int extra, uint64_t nodes) {
+        SearchEvent& e = events[head & mask];
+        e.nodes = (uint32_t)nodes;
+        e.value = (int16_t)value;
+        e.move = move;
+        e.type = type;
+        e.depth = (uint8_t)depth;
+        e.ply = (uint8_t)ply;
+        e.extra = (uint8_t)extra;
+        e.reserved = 0;
+        ++head;
+    }
+
+    void clear() { head = 0; }
+    size_t size() const { return head < events.size() ? (size_t)head : events.size(); }
+
+    // Writes "STRC", the event count and the events from oldest to newest
+    bool dump(const std::string& path) const;
+
+private:
+    std::vector<SearchEvent> events;
+    uint64_t mask;
+    uint64_t head;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "TextureCache.h"
+#include <iostream>
+
+TextureCache& TextureCache::instance() {
+    static TextureCache cache;
+    return cache;
+}
+
+TextureCache::TextureCache() : jobs(256) {
+    int threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1)
+        threads = 1;
+    if (threads > 4)
+        threads = 4;   // decoding a dozen small PNGs does not need more
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back(&TextureCache::decodeLoop, this);
+}
+
+TextureCache::~TextureCache() {
+    jobs.close();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void TextureCache::request(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<Entry>& entry = entries[path];
+        if (entry)
+            return;
+        entry.reset(new Entry);
+    }
+    jobs.push(path);
+}
+
+const sf::Texture* TextureCache::get(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(path);
+    if (it == entries.end())
+        return nullptr;
+
+    Entry& entry = *it->second;
+    if (entry.state == DECODED) {
+        if (entry.texture.loadFromImage(*entry.image)) {
+            entry.state = UPLOADED;
+        } else {
+            std::cerr << "Failed to upload texture: " << path << std::endl;
+            entry.state = FAILED;
+        }
+        entry.image.reset();
+    }
+    return entry.state == UPLOADED ? &entry.texture : nullptr;
+}
+
+void TextureCache::decodeLoop() {
+    std::string path;
+    while (jobs.pop(path)) {
+        // Decode outside the lock; only the state change is published under it
+        std::unique_ptr<sf::Image> image(new sf::Image);
+        bool loaded = image->loadFromFile(path);
+        if (!loaded)
+            std::cerr << "Failed to load texture: " << path << std::endl;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = *entries[path];
+        if (loaded) {
+            entry.image = std::move(image);
+            entry.state = DECODED;
+        } else {
+            entry.state = FAILED;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "BoundedQueue.h"
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Process-wide texture cache shared by every Board. request() queues a file for
+// decoding into an sf::Image on a pool of worker threads and returns at once;
+// get() hands back the texture once it is decoded, uploading it to the GPU on
+// first use. Uploads need the OpenGL context, so get() must be called from the
+// thread that draws; request() may be called from anywhere.
+class TextureCache {
+public:
+    static TextureCache& instance();
+
+    void request(const std::string& path);
+    // nullptr while the file is still being decoded or if it failed to load
+    const sf::Texture* get(const std::string& path);
+
+    ~TextureCache();
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+private:
+    enum State { QUEUED, DECODED, UPLOADED, FAILED };
+
+    struct Entry {
+        State state = QUEUED;
+        std::unique_ptr<sf::Image> image;   // freed after the upload
+        sf::Texture texture;
+    };
+
+    std::mutex mutex;
+    // Entries are never removed, so texture addresses stay valid for the process
+    std::map<std::string, std::unique_ptr<Entry>> entries;
+    BoundedQueue<std::string> jobs;
+    std::vector<std::thread> workers;
+
+    TextureCache();
+    void decodeLoop();
+};
+
+#endif
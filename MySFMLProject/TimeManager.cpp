@@ -0,0 +1,47 @@
+#include "TimeManager.h"
+
+void TimeManager::start(const TimeControl& control) {
+    int available = control.timeLeftMs - control.overheadMs;
+    if (available < 1)
+        available = 1;
+
+    // Without a move count, assume the game lasts about 30 more moves
+    int movesLeft = control.movesToGo > 0 ? control.movesToGo : 30;
+    if (movesLeft > 50)
+        movesLeft = 50;
+
+    softMs = available / movesLeft + control.incrementMs * 3 / 4;
+    hardMs = softMs * 4;
+
+    // Never plan to spend more than a share of what is left on one move
+    int cap = control.movesToGo == 1 ? available : available / 3;
+    if (hardMs > cap)
+        hardMs = cap;
+    if (softMs > hardMs)
+        softMs = hardMs;
+    if (hardMs < 1)
+        hardMs = 1;
+}
+
+bool TimeManager::shouldStop(int elapsedMs, int stableIterations, int scoreDrop) const {
+    if (elapsedMs >= hardMs)
+        return true;
+
+    // A best move that survived several iterations is unlikely to change
+    int scale = 100;
+    if (stableIterations >= 4) scale = 50;
+    else if (stableIterations == 3) scale = 65;
+    else if (stableIterations == 2) scale = 80;
+    else if (stableIterations == 0) scale = 120;
+
+    // A falling score means trouble; spend more to find a way out
+    if (scoreDrop >= 60) scale = scale * 2;
+    else if (scoreDrop >= 30) scale = scale * 3 / 2;
+
+    long long budget = (long long)softMs * scale / 100;
+    if (budget > hardMs)
+        budget = hardMs;
+    // The next iteration takes longer than all previous ones together, so do not
+    // start one that cannot finish within the budget
+    return elapsedMs * 2LL >= budget;
+}
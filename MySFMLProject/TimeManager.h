@@ -0,0 +1,32 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+// The clock as the engine sees it when asked to move
+struct TimeControl {
+    int timeLeftMs = 0;
+    int incrementMs = 0;
+    int movesToGo = 0;        // 0 means the rest of the game (sudden death)
+    int overheadMs = 30;      // kept back for communication lag
+};
+
+// Splits the remaining clock into a per-move budget. The soft limit is checked
+// between iterations and stretched or shrunk by how the search is going; the
+// hard limit is never exceeded, even in the middle of an iteration.
+class TimeManager {
+public:
+    void start(const TimeControl& control);
+
+    int softLimitMs() const { return softMs; }
+    int hardLimitMs() const { return hardMs; }
+
+    // Called after each finished iteration with the time used so far, how many
+    // iterations in a row kept the same best move and by how much the score fell
+    // since the previous iteration (negative when it rose)
+    bool shouldStop(int elapsedMs, int stableIterations, int scoreDrop) const;
+
+private:
+    int softMs = 0;
+    int hardMs = 0;
+};
+
+#endif
@@ -0,0 +1,356 @@
+// Headless engine-vs-engine tournament with SPRT early stopping.
+//
+// Plays game pairs (each opening once with either colour) between two engine
+// configurations, one game per worker thread, and writes one line per game:
+//     <game> <opening> <colour of A> <result> <plies>
+// With --training-out every searched position is also appended to a training
+// data file (TrainingData.h) with its search score and the game result.
+// Games still running when the SPRT decides are dropped, not recorded.
+//
+// Engine options end in -a or -b and apply to that engine only. --nodes and
+// --depth replace the time limit with a fixed budget, which makes the match
+// independent of machine load; the null-move and LMR options set SearchParams.
+// MCTS has no depth, so --depth is rejected for an engine with --searcher mcts.
+//
+// Usage: tournament [--games N] [--threads N] [--openings file.epd] [--out results.txt] [--training-out file.bin]
+//                   [--elo0 0] [--elo1 5] [--alpha 0.05] [--beta 0.05]
+//                   [--movetime-a ms] [--nodes-a N] [--depth-a N] [--hash-a mb]
+//                   [--null-move-a on|off] [--null-reduction-a 2] [--lmr-a on|off] [--lmr-moves-a 3]
+//                   [--searcher-a ab|mcts] [--mcts-threads-a N] [--mcts-leaf-a eval|playout]
+//                   (and the same options ending in -b)
+
+#include "Mcts.h"
+#include "MoveGen.h"
+#include "Search.h"
+#include "TrainingData.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct EngineConfig {
+    std::string name;
+    int hashMegabytes = 16;
+    int moveTimeMs = 100;
+    uint64_t nodes = 0;            // a fixed node budget per move instead of moveTimeMs
+    int depth = 0;                 // a fixed depth per move instead of moveTimeMs
+    SearchParams params;
+    std::string searcher = "ab";   // "ab" (alpha-beta Search) or "mcts"
+    int mctsThreads = 1;
+    std::string mctsLeaf = "eval";
+};
+
+struct TournamentConfig {
+    int games = 1000;
+    int threads = 0;
+    int maxPlies = 400;
+    std::string openingsFile;
+    std::string outFile = "results.txt";
+    std::string trainingFile;
+    double elo0 = 0.0, elo1 = 5.0;
+    double alpha = 0.05, beta = 0.05;
+    EngineConfig engineA, engineB;
+};
+
+enum GameResult { WHITE_WINS, BLACK_WINS, DRAW };
+
+// Sequential probability ratio test on the score of engine A, using the
+// normal approximation of the trinomial (win/draw/loss) log-likelihood ratio
+class Sprt {
+public:
+    Sprt(double elo0, double elo1, double alpha, double beta)
+        : lower(std::log(beta / (1 - alpha))), upper(std::log((1 - beta) / alpha)),
+          s0(expectedScore(elo0)), s1(expectedScore(elo1)) {}
+
+    void add(double score) {
+        if (score == 1.0) ++wins;
+        else if (score == 0.0) ++losses;
+        else ++draws;
+    }
+
+    double llr() const {
+        double n = wins + draws + losses;
+        if (n == 0)
+            return 0.0;
+        double mean = (wins + 0.5 * draws) / n;
+        // Half a game of each outcome is added to the variance estimate, so a
+        // match where every game ends the same way still has a variance and can
+        // reach a bound instead of sitting at 0
+        double w = wins + 0.5, d = draws + 0.5, l = losses + 0.5;
+        double regularMean = (w + 0.5 * d) / (w + d + l);
+        double variance = (w * (1 - regularMean) * (1 - regularMean) + d * (0.5 - regularMean) * (0.5 - regularMean) +
+                           l * regularMean * regularMean) / (w + d + l);
+        return (s1 - s0) * (2 * n * mean - n * (s0 + s1)) / (2 * variance);
+    }
+
+    // -1 when H0 is accepted, 1 when H1 is accepted, 0 while undecided
+    int decision() const {
+        double value = llr();
+        return value >= upper ? 1 : (value <= lower ? -1 : 0);
+    }
+
+    int wins = 0, draws = 0, losses = 0;
+    const double lower, upper;
+
+private:
+    const double s0, s1;
+
+    static double expectedScore(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+};
+
+static double eloFromScore(double score) {
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// One engine of the match, backed by whichever searcher its config asks for
+class Player {
+public:
+    explicit Player(const EngineConfig& config) {
+        if (config.searcher == "mcts")
+            mcts.reset(new MctsSearch(config.mctsThreads, config.hashMegabytes, config.mctsLeaf));
+        else {
+            alphaBeta.reset(new Search(config.hashMegabytes));
+            alphaBeta->setParams(config.params);
+        }
+    }
+
+    SearchResult think(Position& pos, const SearchLimits& limits) {
+        return mcts ? mcts->think(pos, limits) : alphaBeta->think(pos, limits);
+    }
+
+    void clear() {
+        if (mcts) mcts->clear();
+        else alphaBeta->clear();
+    }
+
+private:
+    std::unique_ptr<Search> alphaBeta;
+    std::unique_ptr<MctsSearch> mcts;
+};
+
+static std::vector<std::string> loadOpenings(const std::string& file) {
+    std::vector<std::string> openings;
+    if (!file.empty()) {
+        std::ifstream in(file);
+        if (!in)
+            std::cerr << "Failed to open opening suite: " << file << std::endl;
+        std::string line;
+        while (std::getline(in, line)) {
+            Position pos;
+            if (!line.empty() && pos.setFromFEN(line))
+                openings.push_back(pos.toFEN());
+        }
+    }
+    if (openings.empty()) {
+        openings = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+            "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+            "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 0 2",
+            "rnbqkb1r/pppppppp/5n2/8/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 1 2",
+            "rnbqkbnr/pppp1ppp/4p3/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+            "rnbqkbnr/pp1ppppp/2p5/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+            "rnbqkbnr/pppppppp/8/8/2P5/8/PP1PPPPP/RNBQKBNR b KQkq - 0 1",
+            "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+            "rnbqkb1r/pppp1ppp/4pn2/8/2PP4/8/PP2PPPP/RNBQKBNR w KQkq - 0 3"
+        };
+    }
+    return openings;
+}
+
+static GameResult playGame(const std::string& opening, Player& white, Player& black,
+                           const EngineConfig& whiteConfig, const EngineConfig& blackConfig,
+                           int maxPlies, int& plies, SearchStats stats[2],
+                           std::vector<TrainingRecord>* samples) {
+    Position pos;
+    pos.setFromFEN(opening);
+    white.clear();
+    black.clear();
+
+    for (plies = 0; plies < maxPlies; ++plies) {
+        MoveList legal;
+        generateLegalMoves(pos, legal);
+        if (legal.size() == 0) {
+            if (!pos.inCheck())
+                return DRAW;
+            return pos.sideToMove() == WHITE ? BLACK_WINS : WHITE_WINS;
+        }
+        if (pos.isThreefoldRepetition() || pos.isFiftyMoveDraw() || pos.hasInsufficientMaterial())
+            return DRAW;
+
+        bool whiteToMove = pos.sideToMove() == WHITE;
+        const EngineConfig& toMove = whiteToMove ? whiteConfig : blackConfig;
+        SearchLimits limits;
+        if (toMove.nodes || toMove.depth) {
+            limits.nodes = toMove.nodes;
+            if (toMove.depth)
+                limits.depth = toMove.depth;
+        } else {
+            limits.moveTimeMs = toMove.moveTimeMs;
+        }
+        SearchResult result = (whiteToMove ? white : black).think(pos, limits);
+        stats[whiteToMove ? WHITE : BLACK].add(result.stats);
+        if (samples)
+            samples->push_back(makeTrainingRecord(pos, result.score, 0));
+
+        UndoInfo undo;
+        pos.makeMove(result.bestMove, undo);
+    }
+    return DRAW;
+}
+
+static void runTournament(const TournamentConfig& config) {
+    std::vector<std::string> openings = loadOpenings(config.openingsFile);
+    std::ofstream out(config.outFile);
+    if (!out)
+        std::cerr << "Failed to open results file: " << config.outFile << std::endl;
+
+    int threads = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    if (threads < 1)
+        threads = 1;
+
+    std::atomic<int> nextGame(0);
+    std::atomic<bool> finished(false);
+    std::mutex resultMutex;
+    TrainingWriter training;
+    if (!config.trainingFile.empty())
+        training.open(config.trainingFile);
+    Sprt sprt(config.elo0, config.elo1, config.alpha, config.beta);
+    SearchStats statsA;
+
+    auto worker = [&]() {
+        Player engineA(config.engineA);
+        Player engineB(config.engineB);
+
+        while (!finished) {
+            int game = nextGame++;
+            if (game >= config.games)
+                break;
+
+            // Consecutive games share an opening with colours reversed
+            int opening = (game / 2) % (int)openings.size();
+            bool aIsWhite = game % 2 == 0;
+            int plies = 0;
+            SearchStats stats[2];
+            std::vector<TrainingRecord> samples;
+            std::vector<TrainingRecord>* record = config.trainingFile.empty() ? nullptr : &samples;
+            GameResult result = aIsWhite
+                ? playGame(openings[opening], engineA, engineB, config.engineA, config.engineB, config.maxPlies, plies, stats, record)
+                : playGame(openings[opening], engineB, engineA, config.engineB, config.engineA, config.maxPlies, plies, stats, record);
+
+            // The result is only known now; store it for each position's side to move
+            for (TrainingRecord& sample : samples) {
+                bool white = (sample.sideAndCastling & 1) == WHITE;
+                sample.result = (int8_t)(result == DRAW ? 0 : ((result == WHITE_WINS) == white ? 1 : -1));
+            }
+
+            double scoreA = result == DRAW ? 0.5 : ((result == WHITE_WINS) == aIsWhite ? 1.0 : 0.0);
+            const char* resultText = result == WHITE_WINS ? "1-0" : (result == BLACK_WINS ? "0-1" : "1/2-1/2");
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            // Another game already decided the match
+            if (finished)
+                break;
+            out << game << ' ' << opening << ' ' << (aIsWhite ? 'W' : 'B') << ' ' << resultText << ' ' << plies << '\n';
+            sprt.add(scoreA);
+            for (const TrainingRecord& sample : samples)
+                training.add(sample);
+            statsA.add(stats[aIsWhite ? WHITE : BLACK]);
+
+            std::cout << "Game " << game + 1 << ": " << config.engineA.name << " +" << sprt.wins << " ="
+                      << sprt.draws << " -" << sprt.losses << "  LLR " << sprt.llr() << " [" << sprt.lower
+                      << ", " << sprt.upper << "]" << std::endl;
+
+            if (sprt.decision() != 0) {
+                finished = true;
+                std::cout << "SPRT: " << (sprt.decision() > 0 ? "H1 accepted" : "H0 accepted") << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+        pool.emplace_back(worker);
+    for (auto& t : pool)
+        t.join();
+
+    int total = sprt.wins + sprt.draws + sprt.losses;
+    if (total > 0) {
+        double score = (sprt.wins + 0.5 * sprt.draws) / total;
+        // At 0% or 100% the estimate is infinite; print the bound half a point would give
+        std::cout << "Finished " << total << " games, score " << score * 100 << "%, Elo difference ";
+        if (score >= 1)
+            std::cout << "> " << eloFromScore((total - 0.5) / total) << std::endl;
+        else if (score <= 0)
+            std::cout << "< " << eloFromScore(0.5 / total) << std::endl;
+        else
+            std::cout << eloFromScore(score) << std::endl;
+        std::cout << "Search statistics for " << config.engineA.name << ":\n" << statsA.report();
+    }
+}
+
+// Sets one engine option, named without its -a/-b suffix
+static bool setEngineOption(EngineConfig& engine, const std::string& key, const std::string& value) {
+    if (key == "--movetime") engine.moveTimeMs = std::atoi(value.c_str());
+    else if (key == "--nodes") engine.nodes = std::strtoull(value.c_str(), nullptr, 10);
+    else if (key == "--depth") engine.depth = std::atoi(value.c_str());
+    else if (key == "--hash") engine.hashMegabytes = std::atoi(value.c_str());
+    else if (key == "--null-move") engine.params.nullMove = value != "off";
+    else if (key == "--null-reduction") engine.params.nullMoveReduction = std::atoi(value.c_str());
+    else if (key == "--lmr") engine.params.lateMoveReductions = value != "off";
+    else if (key == "--lmr-moves") engine.params.lmrFullDepthMoves = std::atoi(value.c_str());
+    else if (key == "--searcher") engine.searcher = value;
+    else if (key == "--mcts-threads") engine.mctsThreads = std::atoi(value.c_str());
+    else if (key == "--mcts-leaf") engine.mctsLeaf = value;
+    else return false;
+    return true;
+}
+
+// Options ending in -a configure engine A and options ending in -b engine B
+static bool parseEngineOption(TournamentConfig& config, const std::string& key, const std::string& value) {
+    if (key.size() < 3 || key[key.size() - 2] != '-')
+        return false;
+    char engine = key.back();
+    if (engine != 'a' && engine != 'b')
+        return false;
+    return setEngineOption(engine == 'a' ? config.engineA : config.engineB, key.substr(0, key.size() - 2), value);
+}
+
+int main(int argc, char* argv[]) {
+    TournamentConfig config;
+    config.engineA.name = "A";
+    config.engineB.name = "B";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--games") config.games = std::atoi(value.c_str());
+        else if (key == "--threads") config.threads = std::atoi(value.c_str());
+        else if (key == "--openings") config.openingsFile = value;
+        else if (key == "--out") config.outFile = value;
+        else if (key == "--training-out") config.trainingFile = value;
+        else if (key == "--max-plies") config.maxPlies = std::atoi(value.c_str());
+        else if (key == "--elo0") config.elo0 = std::atof(value.c_str());
+        else if (key == "--elo1") config.elo1 = std::atof(value.c_str());
+        else if (key == "--alpha") config.alpha = std::atof(value.c_str());
+        else if (key == "--beta") config.beta = std::atof(value.c_str());
+        else if (!parseEngineOption(config, key, value))
+            std::cerr << "Unknown option: " << key << std::endl;
+    }
+    for (const EngineConfig* engine : {&config.engineA, &config.engineB}) {
+        if (engine->searcher == "mcts" && engine->depth) {
+            std::cerr << "Engine " << engine->name << ": --depth does not apply to mcts, use --nodes or --movetime"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    runTournament(config);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "TrainingData.h"
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+TrainingRecord makeTrainingRecord(const Position& pos, int score, int result) {
+    PackedPosition packed = packPosition(pos);
+    TrainingRecord record = {};
+    record.occupancy = packed.occupancy;
+    std::memcpy(record.pieces, packed.pieces, sizeof(record.pieces));
+    record.sideAndCastling = packed.sideAndCastling;
+    record.epSquare = packed.epSquare;
+    record.score = (int16_t)(score > 32767 ? 32767 : (score < -32767 ? -32767 : score));
+    record.result = (int8_t)(result > 0 ? 1 : (result < 0 ? -1 : 0));
+    record.halfmove = (uint8_t)(packed.halfmove > 255 ? 255 : packed.halfmove);
+    record.fullmove = packed.fullmove;
+    return record;
+}
+
+void unpackTrainingRecord(const TrainingRecord& record, Position& pos) {
+    PackedPosition packed = {};
+    packed.occupancy = record.occupancy;
+    std::memcpy(packed.pieces, record.pieces, sizeof(packed.pieces));
+    packed.sideAndCastling = record.sideAndCastling;
+    packed.epSquare = record.epSquare;
+    packed.halfmove = record.halfmove;
+    packed.fullmove = record.fullmove;
+    unpackPosition(packed, pos);
+}
+
+TrainingWriter::TrainingWriter(size_t bufferRecords)
+    : file(nullptr), buffer(bufferRecords ? bufferRecords : 1), used(0), count(0) {}
+
+TrainingWriter::~TrainingWriter() {
+    close();
+}
+
+bool TrainingWriter::open(const std::string& path, bool append) {
+    close();
+    file = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (!file) {
+        std::cerr << "Failed to open training data: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TrainingWriter::add(const TrainingRecord& record) {
+    buffer[used++] = record;
+    ++count;
+    if (used == buffer.size())
+        flush();
+}
+
+void TrainingWriter::flush() {
+    if (file && used)
+        std::fwrite(buffer.data(), sizeof(TrainingRecord), used, file);
+    used = 0;
+    if (file)
+        std::fflush(file);
+}
+
+void TrainingWriter::close() {
+    if (!file)
+        return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+TrainingReader::TrainingReader(uint64_t seed)
+    : records(nullptr), count(0), rng(seed), stride(1), cursor(0), remaining(0), epochs(0) {}
+
+bool TrainingReader::open(const std::string& path) {
+    close();
+    if (!mapped.open(path)) {
+        std::cerr << "Failed to open training data: " << path << std::endl;
+        return false;
+    }
+    if (mapped.size() % sizeof(TrainingRecord))
+        std::cerr << "Training data has a partial record at the end: " << path << std::endl;
+    records = (const TrainingRecord*)mapped.data();
+    count = mapped.size() / sizeof(TrainingRecord);
+    remaining = 0;
+    epochs = 0;
+    return true;
+}
+
+void TrainingReader::startEpoch() {
+    cursor = rng() % count;
+    stride = 1;
+    if (count > 2) {
+        // Anywhere in the middle half of the file, nudged until coprime
+        stride = count / 4 + rng() % (count / 2 + 1);
+        while (std::gcd(stride, (uint64_t)count) != 1)
+            ++stride;
+    }
+    remaining = count;
+    ++epochs;
+}
+
+size_t TrainingReader::nextBatch(std::vector<TrainingRecord>& batch, size_t batchSize) {
+    batch.clear();
+    if (count == 0)
+        return 0;
+    while (batch.size() < batchSize) {
+        if (remaining == 0)
+            startEpoch();
+        batch.push_back(records[cursor]);
+        cursor += stride;
+        if (cursor >= count)
+            cursor -= count;
+        --remaining;
+    }
+    return batch.size();
+}
@@ -0,0 +1,89 @@
+#ifndef TRAINING_DATA_H
+#define TRAINING_DATA_H
+
+#include "MappedFile.h"
+#include "PackedPosition.h"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// One labelled position for evaluation training, 32 bytes on disk. The board is
+// packed the same way as PackedPosition; the move counters make room for the
+// search score and the game result, both from the side to move's point of view.
+struct TrainingRecord {
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    uint8_t sideAndCastling;    // bit 0: side to move, bits 1-4: castling rights
+    int8_t epSquare;
+    int16_t score;              // centipawns
+    int8_t result;              // 1 win, 0 draw, -1 loss
+    uint8_t halfmove;           // clamped to 255
+    uint16_t fullmove;
+};
+
+static_assert(sizeof(TrainingRecord) == 32, "TrainingRecord is written to disk as is");
+
+TrainingRecord makeTrainingRecord(const Position& pos, int score, int result);
+void unpackTrainingRecord(const TrainingRecord& record, Position& pos);
+
+// Appends records to a file through a fixed buffer, one fwrite per buffer.
+// The file is the bare records with no header, so files can be concatenated.
+// Not thread-safe; give each thread its own writer or lock around add().
+class TrainingWriter {
+public:
+    explicit TrainingWriter(size_t bufferRecords = 1 << 14);
+    ~TrainingWriter();
+    TrainingWriter(const TrainingWriter&) = delete;
+    TrainingWriter& operator=(const TrainingWriter&) = delete;
+
+    bool open(const std::string& path, bool append = true);
+    void add(const TrainingRecord& record);
+    void flush();
+    void close();
+
+    uint64_t written() const { return count; }
+
+private:
+    FILE* file;
+    std::vector<TrainingRecord> buffer;
+    size_t used;
+    uint64_t count;
+};
+
+// Random access over a memory-mapped record file. nextBatch() walks the file in
+// a fresh shuffled order each epoch without holding an index per record: the
+// order is start + k * stride (mod size) for a random stride coprime to the
+// size, which visits every record once and keeps neighbours in a batch far
+// apart in the file, so they rarely come from the same game.
+class TrainingReader {
+public:
+    explicit TrainingReader(uint64_t seed = 1);
+
+    bool open(const std::string& path);
+    void close() { mapped.close(); records = nullptr; count = 0; }
+
+    size_t size() const { return count; }
+    const TrainingRecord& operator[](size_t i) const { return records[i]; }
+
+    // Copies up to batchSize records into batch, starting a new epoch when the
+    // current one runs out; returns the number copied (0 only for an empty file)
+    size_t nextBatch(std::vector<TrainingRecord>& batch, size_t batchSize);
+    uint64_t epoch() const { return epochs; }
+
+private:
+    MappedFile mapped;
+    const TrainingRecord* records;
+    size_t count;
+    std::mt19937_64 rng;
+
+    uint64_t stride;
+    uint64_t cursor;
+    uint64_t remaining;
+    uint64_t epochs;
+
+    void startEpoch();
+};
+
+#endif
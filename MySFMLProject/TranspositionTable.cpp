@@ -0,0 +1,38 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(int megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(int megabytes) {
+    // Round down to a power of two so the index is a simple mask
+    uint64_t count = 1;
+    uint64_t wanted = (uint64_t)megabytes * 1024 * 1024 / sizeof(TTEntry);
+    while (count * 2 <= wanted)
+        count *= 2;
+    entries.assign(count, TTEntry());
+    mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+    entries.assign(entries.size(), TTEntry());
+}
+
+const TTEntry* TranspositionTable::probe(uint64_t key) const {
+    const TTEntry& entry = entries[key & mask];
+    return entry.key == key && entry.bound != BOUND_NONE ? &entry : nullptr;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, int bound) {
+    TTEntry& entry = entries[key & mask];
+    // Keep a deeper result for the same position, but always take over a different one
+    if (entry.key == key && depth < entry.depth && bound != BOUND_EXACT)
+        return;
+    if (move == NULL_MOVE && entry.key == key)
+        move = entry.move;
+    entry.key = key;
+    entry.move = move;
+    entry.score = (int16_t)score;
+    entry.depth = (int8_t)depth;
+    entry.bound = (uint8_t)bound;
+}
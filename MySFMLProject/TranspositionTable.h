@@ -0,0 +1,39 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "Move.h"
+#include <cstdint>
+#include <vector>
+
+enum Bound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = 3
+};
+
+struct TTEntry {
+    uint64_t key;
+    Move move;
+    int16_t score;
+    int8_t depth;
+    uint8_t bound;
+};
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(int megabytes = 16);
+
+    void resize(int megabytes);
+    void clear();
+
+    // Returns nullptr when the position is not stored
+    const TTEntry* probe(uint64_t key) const;
+    void store(uint64_t key, Move move, int score, int depth, int bound);
+
+private:
+    std::vector<TTEntry> entries;
+    uint64_t mask;
+};
+
+#endif
@@ -0,0 +1,518 @@
+// Offline Texel tuner for the evaluation weights in EvalParams.
+//
+// Reads an EPD file of quiet positions labelled with the game result ("1-0",
+// "0-1", "1/2-1/2" or "[1.0]" / "[0.5]" / "[0.0]" anywhere after the FEN) and
+// minimises the squared error between sigmoid(eval) and the result.
+//
+// Each position is turned into a short sparse feature list once at load time
+// and kept in flat structure-of-arrays buffers; the evaluation during tuning is
+// then a gather-and-multiply over those features (AVX2 when available), so an
+// epoch over millions of positions takes a fraction of a second per thread.
+// The gradient would need a scatter, which AVX2 lacks, so the lists are also
+// inverted once (feature -> positions) and each feature's gradient is a gather
+// over the per-position error slopes instead; threads own disjoint features.
+// King and pawn against king is skipped because evaluate() takes it from the
+// bitbase, not from these terms.
+//
+// Usage: tuner data.epd [--epochs 500] [--rate 1.0] [--threads N] [--k K] [--out tuned.txt]
+
+#include "Attacks.h"
+#include "Evaluate.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Feature layout, shared by the middlegame and endgame weight vectors
+const int PST_BASE = 0;                        // type * 64 + square
+const int MATERIAL_BASE = PST_BASE + 6 * 64;   // type
+const int BISHOP_PAIR = MATERIAL_BASE + 6;
+const int NUM_FEATURES = BISHOP_PAIR + 1;
+
+// Feature lists are padded to a multiple of this so the SIMD loop needs no tail
+const int LANES = 8;
+
+// All positions, structure-of-arrays. Position i owns features
+// [firstFeature[i], firstFeature[i + 1]).
+struct Dataset {
+    std::vector<uint32_t> firstFeature;
+    std::vector<int16_t> featureIndex;
+    std::vector<int8_t> featureCoef;   // +1 per white piece, -1 per black piece, summed
+    std::vector<float> phase;          // middlegame share, gamePhase / MAX_PHASE
+    std::vector<float> tempo;          // +tempo or -tempo, the untapered part of the eval
+    std::vector<float> result;         // 1 white win, 0.5 draw, 0 black win
+
+    // The same features inverted: feature f occurs in the positions
+    // entryPosition[firstEntry[f], firstEntry[f + 1]) with entryCoef, padded to LANES
+    std::vector<uint32_t> firstEntry;
+    std::vector<int32_t> entryPosition;
+    std::vector<int8_t> entryCoef;
+
+    size_t size() const { return result.size(); }
+};
+
+struct Weights {
+    std::vector<float> mg = std::vector<float>(NUM_FEATURES, 0.0f);
+    std::vector<float> eg = std::vector<float>(NUM_FEATURES, 0.0f);
+};
+
+Weights weightsFromParams(const EvalParams& p) {
+    Weights w;
+    for (int type = PAWN; type <= KING; ++type) {
+        w.mg[MATERIAL_BASE + type] = (float)p.materialMg[type];
+        w.eg[MATERIAL_BASE + type] = (float)p.materialEg[type];
+        for (int sq = 0; sq < 64; ++sq) {
+            w.mg[PST_BASE + type * 64 + sq] = (float)p.pstMg[type][sq];
+            w.eg[PST_BASE + type * 64 + sq] = (float)p.pstEg[type][sq];
+        }
+    }
+    w.mg[BISHOP_PAIR] = (float)p.bishopPairMg;
+    w.eg[BISHOP_PAIR] = (float)p.bishopPairEg;
+    return w;
+}
+
+EvalParams paramsFromWeights(const Weights& w, int tempo) {
+    EvalParams p;
+    for (int type = PAWN; type <= KING; ++type) {
+        p.materialMg[type] = (int)std::lround(w.mg[MATERIAL_BASE + type]);
+        p.materialEg[type] = (int)std::lround(w.eg[MATERIAL_BASE + type]);
+        for (int sq = 0; sq < 64; ++sq) {
+            p.pstMg[type][sq] = (int)std::lround(w.mg[PST_BASE + type * 64 + sq]);
+            p.pstEg[type][sq] = (int)std::lround(w.eg[PST_BASE + type * 64 + sq]);
+        }
+    }
+    p.bishopPairMg = (int)std::lround(w.mg[BISHOP_PAIR]);
+    p.bishopPairEg = (int)std::lround(w.eg[BISHOP_PAIR]);
+    p.tempo = tempo;
+    return p;
+}
+
+// Appends the features of pos in the same terms evaluate() uses, from White's point of view
+void addPosition(Dataset& data, const Position& pos, float result) {
+    int coef[NUM_FEATURES] = {};
+    for (int color = WHITE; color <= BLACK; ++color) {
+        int sign = color == WHITE ? 1 : -1;
+        int flip = color == WHITE ? 0 : 56;
+        for (int type = PAWN; type <= KING; ++type) {
+            uint64_t pieces = pos.pieces(makePiece(color, type));
+            if (type != KING)
+                coef[MATERIAL_BASE + type] += sign * popCount(pieces);
+            while (pieces)
+                coef[PST_BASE + type * 64 + (popLsb(pieces) ^ flip)] += sign;
+        }
+        if (popCount(pos.pieces(makePiece(color, BISHOP))) >= 2)
+            coef[BISHOP_PAIR] += sign;
+    }
+
+    data.firstFeature.push_back((uint32_t)data.featureIndex.size());
+    for (int i = 0; i < NUM_FEATURES; ++i) {
+        if (coef[i] != 0) {
+            data.featureIndex.push_back((int16_t)i);
+            data.featureCoef.push_back((int8_t)coef[i]);
+        }
+    }
+    while (data.featureIndex.size() % LANES) {
+        data.featureIndex.push_back(0);
+        data.featureCoef.push_back(0);
+    }
+
+    data.phase.push_back((float)gamePhase(pos) / MAX_PHASE);
+    data.tempo.push_back((float)(pos.sideToMove() == WHITE ? evalParams.tempo : -evalParams.tempo));
+    data.result.push_back(result);
+}
+
+// Result label after the FEN fields, or a negative value if there is none
+float parseResult(const char* begin, const char* end) {
+    std::string rest(begin, end);
+    if (rest.find("1/2-1/2") != std::string::npos) return 0.5f;
+    if (rest.find("1-0") != std::string::npos) return 1.0f;
+    if (rest.find("0-1") != std::string::npos) return 0.0f;
+    size_t bracket = rest.find('[');
+    if (bracket != std::string::npos)
+        return (float)std::atof(rest.c_str() + bracket + 1);
+    return -1.0f;
+}
+
+void parseLines(const char* begin, const char* end, Dataset& data) {
+    Position pos;
+    const char* line = begin;
+    while (line < end) {
+        const char* lineEnd = std::find(line, end, '\n');
+
+        // The result follows the four EPD fields (board, side, castling, en passant)
+        const char* fieldsEnd = line;
+        for (int field = 0; field < 4 && fieldsEnd < lineEnd; ++field) {
+            while (fieldsEnd < lineEnd && *fieldsEnd == ' ') ++fieldsEnd;
+            while (fieldsEnd < lineEnd && *fieldsEnd != ' ') ++fieldsEnd;
+        }
+
+        float result = parseResult(fieldsEnd, lineEnd);
+        if (result >= 0.0f && pos.setFromFEN(std::string(line, fieldsEnd)) && !pos.inCheck() && !isKpk(pos))
+            addPosition(data, pos, result);
+        line = lineEnd + 1;
+    }
+}
+
+void append(Dataset& to, const Dataset& from) {
+    uint32_t base = (uint32_t)to.featureIndex.size();
+    for (uint32_t first : from.firstFeature)
+        to.firstFeature.push_back(base + first);
+    to.featureIndex.insert(to.featureIndex.end(), from.featureIndex.begin(), from.featureIndex.end());
+    to.featureCoef.insert(to.featureCoef.end(), from.featureCoef.begin(), from.featureCoef.end());
+    to.phase.insert(to.phase.end(), from.phase.begin(), from.phase.end());
+    to.tempo.insert(to.tempo.end(), from.tempo.begin(), from.tempo.end());
+    to.result.insert(to.result.end(), from.result.begin(), from.result.end());
+}
+
+// Parses the file in one chunk per thread, split at line boundaries
+bool loadDataset(const std::string& path, int threads, Dataset& data) {
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+    const char* text = (const char*)file.data();
+    const char* end = text + file.size();
+
+    std::vector<const char*> bounds(threads + 1, end);
+    bounds[0] = text;
+    for (int t = 1; t < threads; ++t) {
+        const char* split = std::max(bounds[t - 1], text + file.size() * t / threads);
+        split = std::find(split, end, '\n');
+        bounds[t] = split < end ? split + 1 : end;
+    }
+
+    std::vector<Dataset> parts(threads);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back(parseLines, bounds[t], bounds[t + 1], std::ref(parts[t]));
+    for (auto& t : pool)
+        t.join();
+
+    for (const Dataset& part : parts)
+        append(data, part);
+    data.firstFeature.push_back((uint32_t)data.featureIndex.size());
+    return true;
+}
+
+// Fills the inverted lists from the per-position ones with a counting sort
+void buildFeatureLists(Dataset& data) {
+    std::vector<uint32_t> count(NUM_FEATURES, 0);
+    for (size_t j = 0; j < data.featureIndex.size(); ++j)
+        if (data.featureCoef[j] != 0)
+            ++count[data.featureIndex[j]];
+
+    data.firstEntry.assign(NUM_FEATURES + 1, 0);
+    for (int f = 0; f < NUM_FEATURES; ++f)
+        data.firstEntry[f + 1] = data.firstEntry[f] + (count[f] + LANES - 1) / LANES * LANES;
+    // Padding entries point at position 0 with a zero coefficient
+    data.entryPosition.assign(data.firstEntry[NUM_FEATURES], 0);
+    data.entryCoef.assign(data.firstEntry[NUM_FEATURES], 0);
+
+    std::vector<uint32_t> next(data.firstEntry.begin(), data.firstEntry.end() - 1);
+    for (size_t i = 0; i < data.size(); ++i) {
+        for (uint32_t j = data.firstFeature[i]; j < data.firstFeature[i + 1]; ++j) {
+            if (data.featureCoef[j] == 0)
+                continue;
+            uint32_t entry = next[data.featureIndex[j]]++;
+            data.entryPosition[entry] = (int32_t)i;
+            data.entryCoef[entry] = data.featureCoef[j];
+        }
+    }
+}
+
+// Tapered evaluation of position i from White's point of view
+inline float evaluateFeatures(const Dataset& data, const Weights& w, size_t i) {
+    uint32_t first = data.firstFeature[i], last = data.firstFeature[i + 1];
+    float mg = 0.0f, eg = 0.0f;
+
+#ifdef __AVX2__
+    __m256 accMg = _mm256_setzero_ps(), accEg = _mm256_setzero_ps();
+    for (uint32_t j = first; j < last; j += LANES) {
+        __m256i index = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&data.featureIndex[j]));
+        __m256 coef = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)&data.featureCoef[j])));
+        accMg = _mm256_add_ps(accMg, _mm256_mul_ps(_mm256_i32gather_ps(w.mg.data(), index, 4), coef));
+        accEg = _mm256_add_ps(accEg, _mm256_mul_ps(_mm256_i32gather_ps(w.eg.data(), index, 4), coef));
+    }
+    float lanesMg[LANES], lanesEg[LANES];
+    _mm256_storeu_ps(lanesMg, accMg);
+    _mm256_storeu_ps(lanesEg, accEg);
+    for (int k = 0; k < LANES; ++k) {
+        mg += lanesMg[k];
+        eg += lanesEg[k];
+    }
+#else
+    for (uint32_t j = first; j < last; ++j) {
+        mg += w.mg[data.featureIndex[j]] * data.featureCoef[j];
+        eg += w.eg[data.featureIndex[j]] * data.featureCoef[j];
+    }
+#endif
+
+    float phase = data.phase[i];
+    return mg * phase + eg * (1.0f - phase) + data.tempo[i];
+}
+
+inline float sigmoid(float k, float eval) {
+    return 1.0f / (1.0f + std::pow(10.0f, -k * eval / 400.0f));
+}
+
+// Sum of squared errors over positions [begin, end). When slopeMg/slopeEg are
+// given, also stores d(error)/d(weight) per unit of coefficient for each position,
+// split into its middlegame and endgame shares.
+double errorRange(const Dataset& data, const Weights& w, float k, size_t begin, size_t end,
+                  float* slopeMg, float* slopeEg) {
+    const float scale = k * std::log(10.0f) / 400.0f;
+    double error = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        float s = sigmoid(k, evaluateFeatures(data, w, i));
+        float diff = data.result[i] - s;
+        error += (double)diff * diff;
+        if (!slopeMg)
+            continue;
+
+        float g = -2.0f * diff * s * (1.0f - s) * scale;
+        slopeMg[i] = g * data.phase[i];
+        slopeEg[i] = g * (1.0f - data.phase[i]);
+    }
+    return error;
+}
+
+// Gradient of features [begin, end): the sum of slope * coef over the positions
+// each feature occurs in, written straight into gradMg/gradEg
+void gradientRange(const Dataset& data, const float* slopeMg, const float* slopeEg, int begin, int end,
+                   double* gradMg, double* gradEg) {
+    for (int f = begin; f < end; ++f) {
+        uint32_t first = data.firstEntry[f], last = data.firstEntry[f + 1];
+        double mg = 0.0, eg = 0.0;
+
+#ifdef __AVX2__
+        // Products in float, sums in double: the busiest features occur in every position
+        __m256d accMg = _mm256_setzero_pd(), accEg = _mm256_setzero_pd();
+        for (uint32_t j = first; j < last; j += LANES) {
+            __m256i position = _mm256_loadu_si256((const __m256i*)&data.entryPosition[j]);
+            __m256 coef = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)&data.entryCoef[j])));
+            __m256 productMg = _mm256_mul_ps(_mm256_i32gather_ps(slopeMg, position, 4), coef);
+            __m256 productEg = _mm256_mul_ps(_mm256_i32gather_ps(slopeEg, position, 4), coef);
+            accMg = _mm256_add_pd(accMg, _mm256_cvtps_pd(_mm256_castps256_ps128(productMg)));
+            accMg = _mm256_add_pd(accMg, _mm256_cvtps_pd(_mm256_extractf128_ps(productMg, 1)));
+            accEg = _mm256_add_pd(accEg, _mm256_cvtps_pd(_mm256_castps256_ps128(productEg)));
+            accEg = _mm256_add_pd(accEg, _mm256_cvtps_pd(_mm256_extractf128_ps(productEg, 1)));
+        }
+        double lanesMg[4], lanesEg[4];
+        _mm256_storeu_pd(lanesMg, accMg);
+        _mm256_storeu_pd(lanesEg, accEg);
+        for (int k = 0; k < 4; ++k) {
+            mg += lanesMg[k];
+            eg += lanesEg[k];
+        }
+#else
+        for (uint32_t j = first; j < last; ++j) {
+            mg += slopeMg[data.entryPosition[j]] * data.entryCoef[j];
+            eg += slopeEg[data.entryPosition[j]] * data.entryCoef[j];
+        }
+#endif
+
+        gradMg[f] = mg;
+        gradEg[f] = eg;
+    }
+}
+
+// Mean squared error over the whole set, optionally with its gradient. Threads
+// first split the positions to compute errors and slopes, then split the
+// features, by entry count, to sum the slopes into the gradient.
+double meanError(const Dataset& data, const Weights& w, float k, int threads,
+                 std::vector<double>* gradMg = nullptr, std::vector<double>* gradEg = nullptr) {
+    std::vector<double> errors(threads, 0.0);
+    std::vector<float> slopeMg(gradMg ? data.size() : 0), slopeEg(gradMg ? data.size() : 0);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        size_t begin = data.size() * t / threads, end = data.size() * (t + 1) / threads;
+        pool.emplace_back([&, t, begin, end]() {
+            errors[t] = errorRange(data, w, k, begin, end, gradMg ? slopeMg.data() : nullptr,
+                                   gradMg ? slopeEg.data() : nullptr);
+        });
+    }
+    for (auto& t : pool)
+        t.join();
+
+    double error = 0.0;
+    for (int t = 0; t < threads; ++t)
+        error += errors[t];
+
+    if (gradMg) {
+        pool.clear();
+        uint64_t entries = data.firstEntry[NUM_FEATURES];
+        int begin = 0;
+        for (int t = 0; t < threads; ++t) {
+            int end = NUM_FEATURES;
+            if (t + 1 < threads) {
+                uint64_t target = entries * (t + 1) / threads;
+                end = (int)(std::lower_bound(data.firstEntry.begin(), data.firstEntry.end(), target) -
+                            data.firstEntry.begin());
+                end = std::min(std::max(end, begin), NUM_FEATURES);
+            }
+            pool.emplace_back(gradientRange, std::cref(data), slopeMg.data(), slopeEg.data(), begin, end,
+                              gradMg->data(), gradEg->data());
+            begin = end;
+        }
+        for (auto& t : pool)
+            t.join();
+    }
+    return error / (double)data.size();
+}
+
+// Golden-section search for the sigmoid scale that best fits the current weights
+float fitScale(const Dataset& data, const Weights& w, int threads) {
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double lo = 0.2, hi = 3.0;
+    double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+    double errorA = meanError(data, w, (float)a, threads), errorB = meanError(data, w, (float)b, threads);
+    for (int i = 0; i < 30; ++i) {
+        if (errorA < errorB) {
+            hi = b;
+            b = a;
+            errorB = errorA;
+            a = hi - ratio * (hi - lo);
+            errorA = meanError(data, w, (float)a, threads);
+        } else {
+            lo = a;
+            a = b;
+            errorA = errorB;
+            b = lo + ratio * (hi - lo);
+            errorB = meanError(data, w, (float)b, threads);
+        }
+    }
+    return (float)((lo + hi) / 2.0);
+}
+
+// Adam on both weight vectors. The loops run over flat float arrays so the
+// compiler vectorises them.
+void tune(const Dataset& data, Weights& w, float k, int epochs, float rate, int threads) {
+    const float beta1 = 0.9f, beta2 = 0.999f, epsilon = 1e-8f;
+    std::vector<float> momentMg(NUM_FEATURES, 0.0f), momentEg(NUM_FEATURES, 0.0f);
+    std::vector<float> velocityMg(NUM_FEATURES, 0.0f), velocityEg(NUM_FEATURES, 0.0f);
+    std::vector<double> gradMg(NUM_FEATURES), gradEg(NUM_FEATURES);
+
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        double error = meanError(data, w, k, threads, &gradMg, &gradEg);
+
+        float correction1 = 1.0f - std::pow(beta1, (float)epoch);
+        float correction2 = 1.0f - std::pow(beta2, (float)epoch);
+        float inverseCount = 1.0f / (float)data.size();
+        auto step = [&](std::vector<float>& weights, std::vector<float>& moment, std::vector<float>& velocity,
+                        const std::vector<double>& grad) {
+            for (int i = 0; i < NUM_FEATURES; ++i) {
+                float g = (float)grad[i] * inverseCount;
+                moment[i] = beta1 * moment[i] + (1.0f - beta1) * g;
+                velocity[i] = beta2 * velocity[i] + (1.0f - beta2) * g * g;
+                weights[i] -= rate * (moment[i] / correction1) / (std::sqrt(velocity[i] / correction2) + epsilon);
+            }
+        };
+        step(w.mg, momentMg, velocityMg, gradMg);
+        step(w.eg, momentEg, velocityEg, gradEg);
+
+        if (epoch == 1 || epoch % 50 == 0 || epoch == epochs)
+            std::cout << "epoch " << epoch << "  error " << std::setprecision(8) << error << std::endl;
+    }
+}
+
+void writeTable(std::ostream& out, const char* name, const int* table) {
+    out << "const int " << name << "[64] = {\n";
+    for (int row = 0; row < 8; ++row) {
+        out << "   ";
+        for (int col = 0; col < 8; ++col)
+            out << ' ' << std::setw(4) << table[row * 8 + col] << (row * 8 + col < 63 ? "," : "");
+        out << '\n';
+    }
+    out << "};\n\n";
+}
+
+// Writes the tuned terms in the same layout as the tables in Evaluate.cpp
+void writeParams(std::ostream& out, const EvalParams& p) {
+    const char* names[6] = {"PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"};
+    out << "materialMg = {";
+    for (int type = PAWN; type <= KING; ++type)
+        out << p.materialMg[type] << (type < KING ? ", " : "};\n");
+    out << "materialEg = {";
+    for (int type = PAWN; type <= KING; ++type)
+        out << p.materialEg[type] << (type < KING ? ", " : "};\n");
+    out << "bishopPair = " << p.bishopPairMg << ", " << p.bishopPairEg << "\n\n";
+
+    for (int type = PAWN; type <= KING; ++type) {
+        std::string mg = std::string(names[type]) + "_MG_TABLE";
+        std::string eg = std::string(names[type]) + "_EG_TABLE";
+        writeTable(out, mg.c_str(), p.pstMg[type]);
+        writeTable(out, eg.c_str(), p.pstEg[type]);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: tuner data.epd [--epochs N] [--rate R] [--threads N] [--k K] [--out file]" << std::endl;
+        return 1;
+    }
+
+    std::string inFile = argv[1];
+    std::string outFile = "tuned.txt";
+    int epochs = 500;
+    int threads = (int)std::thread::hardware_concurrency();
+    float rate = 1.0f;
+    float k = 0.0f;   // 0 means fit it to the data first
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--epochs") epochs = std::atoi(value.c_str());
+        else if (key == "--rate") rate = (float)std::atof(value.c_str());
+        else if (key == "--threads") threads = std::atoi(value.c_str());
+        else if (key == "--k") k = (float)std::atof(value.c_str());
+        else if (key == "--out") outFile = value;
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+    if (threads < 1)
+        threads = 1;
+
+    Dataset data;
+    if (!loadDataset(inFile, threads, data))
+        return 1;
+    if (data.size() == 0) {
+        std::cerr << "No labelled positions in " << inFile << std::endl;
+        return 1;
+    }
+    buildFeatureLists(data);
+    std::cout << "Loaded " << data.size() << " positions, " << data.featureIndex.size() << " feature slots"
+              << std::endl;
+
+    Weights weights = weightsFromParams(evalParams);
+    if (k <= 0.0f) {
+        k = fitScale(data, weights, threads);
+        std::cout << "Fitted K = " << k << std::endl;
+    }
+    std::cout << "Initial error " << std::setprecision(8) << meanError(data, weights, k, threads) << std::endl;
+
+    tune(data, weights, k, epochs, rate, threads);
+
+    std::ofstream out(outFile);
+    if (!out) {
+        std::cerr << "Failed to write " << outFile << std::endl;
+        return 1;
+    }
+    writeParams(out, paramsFromWeights(weights, evalParams.tempo));
+    std::cout << "Wrote " << outFile << std::endl;
+    return 0;
+}
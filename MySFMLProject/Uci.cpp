@@ -0,0 +1,196 @@
+// Minimal UCI front end for the engine, so it can play on servers and in GUIs.
+//
+// Supports uci, isready, ucinewgame, setoption (Hash, MultiPV), position,
+// go (wtime btime winc binc movestogo movetime depth nodes infinite ponder),
+// ponderhit, stop and quit. The search runs on its own thread so stop and
+// ponderhit are handled while it thinks.
+//
+// Pondering: "go ponder" searches the position after the predicted reply with
+// no time limit. On ponderhit the same search carries on against our clock; on
+// a miss the GUI sends stop and a new go, and the new search starts from the
+// transposition table the ponder search filled.
+
+#include "MoveGen.h"
+#include "Search.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string scoreToString(int score) {
+    if (!isMateScore(score))
+        return "cp " + std::to_string(score);
+    int plies = MATE_SCORE - (score > 0 ? score : -score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+class UciEngine {
+public:
+    UciEngine() : search(new Search(hashMegabytes)) {}
+    ~UciEngine() { stopSearch(); }
+
+    void run() {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            std::istringstream in(line);
+            std::string command;
+            in >> command;
+
+            if (command == "uci") {
+                std::cout << "id name MySFMLProject\n"
+                          << "option name Hash type spin default 16 min 1 max 4096\n"
+                          << "option name MultiPV type spin default 1 min 1 max 64\n"
+                          << "option name Ponder type check default true\n"
+                          << "uciok" << std::endl;
+            } else if (command == "isready") {
+                std::cout << "readyok" << std::endl;
+            } else if (command == "ucinewgame") {
+                stopSearch();
+                search->clear();
+            } else if (command == "setoption") {
+                setOption(in);
+            } else if (command == "position") {
+                stopSearch();
+                setPosition(in);
+            } else if (command == "go") {
+                stopSearch();
+                go(in);
+            } else if (command == "ponderhit") {
+                search->ponderHit();
+                release();
+            } else if (command == "stop") {
+                stopSearch();
+            } else if (command == "quit") {
+                break;
+            }
+        }
+    }
+
+private:
+    int hashMegabytes = 16;
+    int multiPV = 1;
+    Position position;
+    std::unique_ptr<Search> search;
+    std::thread worker;
+
+    // Set while a ponder or infinite search may not report its move yet
+    std::mutex holdMutex;
+    std::condition_variable holdChanged;
+    bool holdResult = false;
+
+    void setOption(std::istringstream& in) {
+        std::string token, name, value;
+        in >> token >> name >> token >> value;
+        if (name == "Hash") {
+            stopSearch();
+            hashMegabytes = std::atoi(value.c_str());
+            search.reset(new Search(hashMegabytes));
+        } else if (name == "MultiPV") {
+            multiPV = std::atoi(value.c_str());
+        }
+    }
+
+    void setPosition(std::istringstream& in) {
+        std::string token;
+        in >> token;
+        if (token == "startpos") {
+            position.setStartPosition();
+            in >> token;
+        } else if (token == "fen") {
+            std::string fen;
+            while (in >> token && token != "moves")
+                fen += token + " ";
+            position.setFromFEN(fen);
+        }
+        if (token != "moves")
+            return;
+        while (in >> token) {
+            Move m = parseMove(position, token);
+            if (m == NULL_MOVE)
+                break;
+            UndoInfo undo;
+            position.makeMove(m, undo);
+        }
+    }
+
+    void go(std::istringstream& in) {
+        SearchLimits limits;
+        limits.multiPV = multiPV;
+        bool infinite = false;
+        bool white = position.sideToMove() == WHITE;
+        std::string token;
+        while (in >> token) {
+            int value = 0;
+            if (token == "infinite") infinite = true;
+            else if (token == "ponder") limits.ponder = true;
+            else if (!(in >> value)) break;
+            else if (token == (white ? "wtime" : "btime")) limits.timeLeftMs = value > 1 ? value : 1;
+            else if (token == (white ? "winc" : "binc")) limits.incrementMs = value;
+            else if (token == "movestogo") limits.movesToGo = value;
+            else if (token == "movetime") limits.moveTimeMs = value;
+            else if (token == "depth") limits.depth = value < MAX_PLY - 1 ? value : MAX_PLY - 1;
+            else if (token == "nodes") limits.nodes = (uint64_t)value;
+        }
+
+        holdResult = infinite || limits.ponder;
+        // A stop sent right after go must reach this search even if the worker has
+        // not called think() yet, so the flag is reset here and not inside think()
+        search->clearStop();
+        worker = std::thread([this, limits]() {
+            Position pos = position;
+            SearchResult result = search->think(pos, limits);
+
+            // UCI forbids a bestmove before ponderhit or stop
+            std::unique_lock<std::mutex> lock(holdMutex);
+            holdChanged.wait(lock, [this]() { return !holdResult; });
+            report(result);
+        });
+    }
+
+    void report(const SearchResult& result) {
+        uint64_t nps = result.nodes * 1000 / (result.timeMs > 0 ? result.timeMs : 1);
+        for (size_t i = 0; i < result.lines.size(); ++i) {
+            const SearchLine& line = result.lines[i];
+            std::cout << "info depth " << result.depth << " multipv " << i + 1 << " score "
+                      << scoreToString(line.score) << " time " << result.timeMs << " nodes " << result.nodes
+                      << " nps " << nps << " pv";
+            for (Move m : line.pv)
+                std::cout << ' ' << moveToString(m);
+            std::cout << '\n';
+        }
+        std::cout << "bestmove " << (result.bestMove == NULL_MOVE ? "0000" : moveToString(result.bestMove));
+        if (result.pv.size() > 1)
+            std::cout << " ponder " << moveToString(result.pv[1]);
+        std::cout << std::endl;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        holdResult = false;
+        holdChanged.notify_all();
+    }
+
+    void stopSearch() {
+        if (!worker.joinable())
+            return;
+        search->stop();
+        release();
+        worker.join();
+    }
+};
+
+}
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    UciEngine engine;
+    engine.run();
+    return 0;
+}
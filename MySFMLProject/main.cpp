@@ -21,6 +21,18 @@ int main() {
                     board.handleClick(mouseX, mouseY);
                 }
             }
+
+            // Arrow keys step through the game, Home/End jump to either end
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::Left)
+                    board.undoMove();
+                else if (event.key.code == sf::Keyboard::Right)
+                    board.redoMove();
+                else if (event.key.code == sf::Keyboard::Home)
+                    board.jumpToPly(0);
+                else if (event.key.code == sf::Keyboard::End)
+                    board.jumpToPly(board.gameLength());
+            }
         }
     
         window.clear();
@@ -0,0 +1,194 @@
+// Batch sudoku solver: solves every puzzle in a file of 81-character lines and
+// writes one line per puzzle, in input order.
+//
+// The input is memory-mapped and cut into line-aligned chunks of about a
+// megabyte; worker threads take chunks in turn, each with its own solver, and
+// the main thread writes finished chunks out as soon as all earlier ones are
+// done. Output lines are the solution, or "invalid" (not 81 digits and dots),
+// "unsolvable", or with --unique "multiple" when a puzzle has more than one
+// solution. Blank lines are skipped. Totals and puzzles per second go to stderr.
+//
+// Usage: batchsolve puzzles.txt [--out solutions.txt] [--threads N] [--solver propagate|bitmask|dlx] [--unique]
+
+#include "BoundedQueue.h"
+#include "MappedFile.h"
+#include "SudokuSolver.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t CHUNK_BYTES = 1 << 20;
+
+struct Chunk {
+    size_t begin;
+    size_t end;
+};
+
+struct ChunkResult {
+    size_t index = 0;
+    std::string text;
+    uint64_t puzzles = 0, solved = 0, unsolvable = 0, multiple = 0, invalid = 0;
+};
+
+// Byte ranges of about CHUNK_BYTES, each ending just after a newline
+std::vector<Chunk> splitLines(const uint8_t* data, size_t size) {
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    while (begin < size) {
+        size_t end = begin + CHUNK_BYTES < size ? begin + CHUNK_BYTES : size;
+        const void* newline = end < size ? std::memchr(data + end, '\n', size - end) : nullptr;
+        end = newline ? (size_t)((const uint8_t*)newline - data) + 1 : size;
+        chunks.push_back(Chunk{begin, end});
+        begin = end;
+    }
+    return chunks;
+}
+
+void solveChunk(SudokuSolver& solver, const char* text, size_t length, int limit, ChunkResult& result) {
+    result.text.reserve(length);
+    Grid puzzle, solution;
+    char line[82];
+    line[81] = '\n';
+    for (size_t pos = 0; pos < length;) {
+        const char* newline = (const char*)std::memchr(text + pos, '\n', length - pos);
+        size_t end = newline ? (size_t)(newline - text) : length;
+        size_t lineLength = end - pos;
+        if (lineLength > 0 && text[pos + lineLength - 1] == '\r')
+            --lineLength;
+
+        if (lineLength > 0) {
+            ++result.puzzles;
+            int found = 0;
+            if (lineLength != 81 || !parseGrid(text + pos, lineLength, puzzle)) {
+                ++result.invalid;
+                result.text += "invalid\n";
+            } else if ((found = solver.solve(puzzle, solution, limit)) == 0) {
+                ++result.unsolvable;
+                result.text += "unsolvable\n";
+            } else if (found > 1) {
+                ++result.multiple;
+                result.text += "multiple\n";
+            } else {
+                ++result.solved;
+                formatGrid(solution, line);
+                result.text.append(line, 82);
+            }
+        }
+        pos = end + 1;
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: batchsolve puzzles.txt [--out solutions.txt] [--threads N] [--solver name] [--unique]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string inFile = argv[1];
+    std::string outFile;
+    std::string solverName = "propagate";
+    int threads = (int)std::thread::hardware_concurrency();
+    int limit = 1;
+    for (int i = 2; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--unique") limit = 2;
+        else if (key == "--out" && i + 1 < argc) outFile = argv[++i];
+        else if (key == "--threads" && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (key == "--solver" && i + 1 < argc) solverName = argv[++i];
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+    if (threads < 1)
+        threads = 1;
+    if (!makeSolver(solverName)) {
+        std::cerr << "Unknown solver: " << solverName << std::endl;
+        return 1;
+    }
+
+    MappedFile input;
+    if (!input.open(inFile)) {
+        std::cerr << "Failed to open " << inFile << std::endl;
+        return 1;
+    }
+    FILE* out = outFile.empty() ? stdout : std::fopen(outFile.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Failed to write " << outFile << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const char* text = (const char*)input.data();
+    std::vector<Chunk> chunks = splitLines(input.data(), input.size());
+
+    BoundedQueue<ChunkResult> finished((size_t)threads * 2);
+    InFlightWindow window((size_t)threads * 4);
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<int> activeWorkers(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            std::unique_ptr<SudokuSolver> solver = makeSolver(solverName);
+            for (;;) {
+                window.acquire();
+                size_t index = nextChunk++;
+                if (index >= chunks.size()) {
+                    window.release();
+                    break;
+                }
+                ChunkResult result;
+                result.index = index;
+                solveChunk(*solver, text + chunks[index].begin, chunks[index].end - chunks[index].begin, limit,
+                           result);
+                finished.push(std::move(result));
+            }
+            if (--activeWorkers == 0)
+                finished.close();
+        });
+    }
+
+    // Chunks finish out of order; hold them until their turn comes
+    std::map<size_t, ChunkResult> waiting;
+    size_t nextIndex = 0;
+    ChunkResult total;
+    ChunkResult result;
+    while (finished.pop(result)) {
+        waiting[result.index] = std::move(result);
+        while (!waiting.empty() && waiting.begin()->first == nextIndex) {
+            const ChunkResult& ready = waiting.begin()->second;
+            std::fwrite(ready.text.data(), 1, ready.text.size(), out);
+            total.puzzles += ready.puzzles;
+            total.solved += ready.solved;
+            total.unsolvable += ready.unsolvable;
+            total.multiple += ready.multiple;
+            total.invalid += ready.invalid;
+            waiting.erase(waiting.begin());
+            ++nextIndex;
+            window.release();
+        }
+    }
+    for (auto& worker : workers)
+        worker.join();
+    if (out != stdout)
+        std::fclose(out);
+    else
+        std::fflush(out);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << total.puzzles << " puzzles: " << total.solved << " solved, " << total.unsolvable << " unsolvable, "
+              << total.multiple << " multiple, " << total.invalid << " invalid" << std::endl;
+    std::cerr << "Time " << seconds << " s, " << (uint64_t)(total.puzzles / (seconds > 0 ? seconds : 1e-9))
+              << " puzzles/second with " << threads << " threads (" << solverName << ")" << std::endl;
+    return 0;
+}
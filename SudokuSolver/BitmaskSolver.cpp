@@ -0,0 +1,92 @@
+#include "BitmaskSolver.h"
+#include <cstring>
+
+namespace {
+
+const uint16_t ALL_DIGITS = 0x1FF;
+
+inline int popCount(unsigned mask) { return __builtin_popcount(mask); }
+inline int lsb(unsigned mask) { return __builtin_ctz(mask); }
+
+}
+
+int BitmaskSolver::solve(const Grid& puzzle, Grid& result, int maxSolutions) {
+    std::memset(rowUsed, 0, sizeof(rowUsed));
+    std::memset(colUsed, 0, sizeof(colUsed));
+    std::memset(boxUsed, 0, sizeof(boxUsed));
+    emptyCount = 0;
+    found = 0;
+    limit = maxSolutions > 0 ? maxSolutions : 1;
+    solution = &result;
+
+    for (int cell = 0; cell < 81; ++cell) {
+        int digit = puzzle.cells[cell];
+        cells[cell] = (uint8_t)digit;
+        if (digit == 0) {
+            empty[emptyCount++] = (uint8_t)cell;
+            continue;
+        }
+        uint16_t bit = (uint16_t)(1 << (digit - 1));
+        int row = cellRow(cell), col = cellCol(cell), box = cellBox(cell);
+        // A clue repeated in its row, column or box: no solution at all
+        if ((rowUsed[row] | colUsed[col] | boxUsed[box]) & bit)
+            return 0;
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[box] |= bit;
+    }
+
+    search(0);
+    return found;
+}
+
+void BitmaskSolver::search(int depth) {
+    if (depth == emptyCount) {
+        if (found++ == 0)
+            std::memcpy(solution->cells, cells, sizeof(cells));
+        return;
+    }
+
+    // Most constrained cell among those still empty
+    int bestIndex = depth;
+    unsigned bestCandidates = 0;
+    int bestCount = 10;
+    for (int i = depth; i < emptyCount; ++i) {
+        int cell = empty[i];
+        unsigned candidates = ~(rowUsed[cellRow(cell)] | colUsed[cellCol(cell)] | boxUsed[cellBox(cell)]) & ALL_DIGITS;
+        int count = popCount(candidates);
+        if (count < bestCount) {
+            bestCount = count;
+            bestIndex = i;
+            bestCandidates = candidates;
+            if (count <= 1)
+                break;
+        }
+    }
+    if (bestCount == 0)
+        return;
+
+    uint8_t cell = empty[bestIndex];
+    empty[bestIndex] = empty[depth];
+    empty[depth] = cell;
+
+    int row = cellRow(cell), col = cellCol(cell), box = cellBox(cell);
+    while (bestCandidates && found < limit) {
+        int digit = lsb(bestCandidates);
+        bestCandidates &= bestCandidates - 1;
+        uint16_t bit = (uint16_t)(1 << digit);
+
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[box] |= bit;
+        cells[cell] = (uint8_t)(digit + 1);
+        search(depth + 1);
+        rowUsed[row] ^= bit;
+        colUsed[col] ^= bit;
+        boxUsed[box] ^= bit;
+    }
+    cells[cell] = 0;
+
+    empty[depth] = empty[bestIndex];
+    empty[bestIndex] = cell;
+}
@@ -0,0 +1,31 @@
+#ifndef BITMASK_SOLVER_H
+#define BITMASK_SOLVER_H
+
+#include "SudokuSolver.h"
+
+// Backtracking over 9-bit masks of the digits used in each row, column and box.
+// Every step fills the empty cell with the fewest candidates (a popcount of the
+// three masks combined), so forced cells go first and dead ends show up as a
+// cell with none. Placing and removing a digit is three ORs and three XORs;
+// all state lives in fixed arrays, so a solve never allocates.
+class BitmaskSolver : public SudokuSolver {
+public:
+    int solve(const Grid& puzzle, Grid& solution, int limit = 1) override;
+    const char* name() const override { return "bitmask"; }
+
+private:
+    uint16_t rowUsed[9];
+    uint16_t colUsed[9];
+    uint16_t boxUsed[9];
+    uint8_t cells[81];
+    uint8_t empty[81];     // empty cells; the first `depth` of them are filled
+    int emptyCount;
+
+    int found;
+    int limit;
+    Grid* solution;
+
+    void search(int depth);
+};
+
+#endif
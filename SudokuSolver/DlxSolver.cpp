@@ -0,0 +1,134 @@
+#include "DlxSolver.h"
+#include <cstring>
+
+DlxSolver::DlxSolver() {
+    for (int c = 0; c <= COLUMNS; ++c) {
+        left[c] = c == 0 ? COLUMNS : c - 1;
+        right[c] = c == COLUMNS ? 0 : c + 1;
+        up[c] = down[c] = c;
+        column[c] = c;
+        rowOf[c] = -1;
+        size[c] = 0;
+    }
+
+    int node = COLUMNS + 1;
+    for (int row = 0; row < ROWS; ++row) {
+        int cell = row / 9, digit = row % 9;
+        int columns[4] = {
+            1 + cell,
+            1 + 81 + cellRow(cell) * 9 + digit,
+            1 + 162 + cellCol(cell) * 9 + digit,
+            1 + 243 + cellBox(cell) * 9 + digit,
+        };
+        firstNode[row] = node;
+        for (int i = 0; i < 4; ++i, ++node) {
+            int c = columns[i];
+            column[node] = c;
+            rowOf[node] = row;
+            up[node] = up[c];
+            down[node] = c;
+            down[up[c]] = node;
+            up[c] = node;
+            ++size[c];
+            left[node] = i == 0 ? node + 3 : node - 1;
+            right[node] = i == 3 ? node - 3 : node + 1;
+        }
+    }
+}
+
+void DlxSolver::cover(int c) {
+    right[left[c]] = right[c];
+    left[right[c]] = left[c];
+    for (int i = down[c]; i != c; i = down[i]) {
+        for (int j = right[i]; j != i; j = right[j]) {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            --size[column[j]];
+        }
+    }
+}
+
+void DlxSolver::uncover(int c) {
+    for (int i = up[c]; i != c; i = up[i]) {
+        for (int j = left[i]; j != i; j = left[j]) {
+            ++size[column[j]];
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    }
+    right[left[c]] = c;
+    left[right[c]] = c;
+}
+
+// Takes node's row into the cover: every column it satisfies is covered
+void DlxSolver::selectRow(int node) {
+    cover(column[node]);
+    for (int j = right[node]; j != node; j = right[j])
+        cover(column[j]);
+}
+
+void DlxSolver::unselectRow(int node) {
+    for (int j = left[node]; j != node; j = left[j])
+        uncover(column[j]);
+    uncover(column[node]);
+}
+
+int DlxSolver::solve(const Grid& grid, Grid& result, int maxSolutions) {
+    found = 0;
+    limit = maxSolutions > 0 ? maxSolutions : 1;
+    solution = &result;
+    puzzle = &grid;
+
+    // A clue whose constraints another clue already took has no solution;
+    // a column is covered exactly when it has been unlinked from the header list
+    int clues[81];
+    int clueCount = 0;
+    bool consistent = true;
+    for (int cell = 0; cell < 81 && consistent; ++cell) {
+        if (grid.cells[cell] == 0)
+            continue;
+        int node = firstNode[cell * 9 + grid.cells[cell] - 1];
+        for (int i = 0, j = node; i < 4 && consistent; ++i, j = right[j])
+            consistent = right[left[column[j]]] == column[j];
+        if (consistent) {
+            selectRow(node);
+            clues[clueCount++] = node;
+        }
+    }
+
+    if (consistent)
+        search(0);
+
+    while (clueCount > 0)
+        unselectRow(clues[--clueCount]);
+    return found;
+}
+
+void DlxSolver::search(int depth) {
+    if (right[0] == 0) {
+        if (found++ == 0) {
+            std::memcpy(solution->cells, puzzle->cells, 81);
+            for (int i = 0; i < depth; ++i)
+                solution->cells[rowOf[chosen[i]] / 9] = (uint8_t)(rowOf[chosen[i]] % 9 + 1);
+        }
+        return;
+    }
+
+    int best = right[0];
+    for (int c = right[best]; c != 0 && size[best] > 1; c = right[c])
+        if (size[c] < size[best])
+            best = c;
+    if (size[best] == 0)
+        return;
+
+    cover(best);
+    for (int r = down[best]; r != best && found < limit; r = down[r]) {
+        chosen[depth] = r;
+        for (int j = right[r]; j != r; j = right[j])
+            cover(column[j]);
+        search(depth + 1);
+        for (int j = left[r]; j != r; j = left[j])
+            uncover(column[j]);
+    }
+    uncover(best);
+}
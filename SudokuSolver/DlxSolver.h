@@ -0,0 +1,46 @@
+#ifndef DLX_SOLVER_H
+#define DLX_SOLVER_H
+
+#include "SudokuSolver.h"
+
+// Knuth's Algorithm X with dancing links over the sudoku exact-cover matrix:
+// 324 constraint columns (each cell filled, each digit once per row, column
+// and box) and 729 candidate rows (a digit in a cell) of 4 nodes each.
+//
+// The matrix is built once, in flat index-linked arrays, when the solver is
+// constructed. A solve covers the rows of the clues, searches, and uncovers
+// everything again on the way out, so nothing is allocated per puzzle. The
+// search branches on the column with the fewest remaining rows.
+class DlxSolver : public SudokuSolver {
+public:
+    DlxSolver();
+
+    int solve(const Grid& puzzle, Grid& solution, int limit = 1) override;
+    const char* name() const override { return "dlx"; }
+
+private:
+    static const int COLUMNS = 324;
+    static const int ROWS = 729;
+    static const int NODES = 1 + COLUMNS + ROWS * 4;   // root, column headers, row nodes
+
+    // Links by node index; node 0 is the root and 1..COLUMNS the column headers
+    int left[NODES], right[NODES], up[NODES], down[NODES];
+    int column[NODES];
+    int rowOf[NODES];
+    int size[COLUMNS + 1];
+    int firstNode[ROWS];   // first of each candidate row's 4 nodes
+
+    int chosen[81];        // row nodes picked by the search, one per depth
+    int found;
+    int limit;
+    Grid* solution;
+    const Grid* puzzle;
+
+    void cover(int c);
+    void uncover(int c);
+    void selectRow(int node);
+    void unselectRow(int node);
+    void search(int depth);
+};
+
+#endif
@@ -0,0 +1,125 @@
+// Puzzle generator: writes sudoku puzzles with a unique solution, one
+// 81-character line each, until the requested number in the requested
+// difficulty band has been found.
+//
+// Each attempt runs the whole pipeline on one worker thread: a random full
+// grid, clue removal checked for uniqueness by a two-solution-limited solve,
+// then a rating; puzzles outside the band are thrown away. Threads take
+// attempt numbers in turn and attempt i seeds its generator from (seed, i).
+// Finished attempts are written in attempt order, so the output depends only
+// on the seed, not on the thread count or on which thread finishes first.
+//
+// Usage: generate [--count 100] [--difficulty easy|medium|hard|expert] [--threads N] [--seed 1]
+//                 [--out puzzles.txt] [--solver propagate|bitmask|dlx]
+
+#include "Generator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Mixes the run seed and an attempt number into a generator seed (splitmix64)
+static uint32_t attemptSeed(unsigned seed, uint64_t attempt) {
+    uint64_t z = ((uint64_t)seed << 32 ^ attempt) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)(z ^ (z >> 31));
+}
+
+int main(int argc, char* argv[]) {
+    int count = 100;
+    std::string difficulty = "medium";
+    int threads = (int)std::thread::hardware_concurrency();
+    unsigned seed = 1;
+    std::string outFile;
+    std::string solverName = "propagate";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--count") count = std::atoi(value.c_str());
+        else if (key == "--difficulty") difficulty = value;
+        else if (key == "--threads") threads = std::atoi(value.c_str());
+        else if (key == "--seed") seed = (unsigned)std::strtoul(value.c_str(), nullptr, 10);
+        else if (key == "--out") outFile = value;
+        else if (key == "--solver") solverName = value;
+        else std::cerr << "Unknown option: " << key << std::endl;
+    }
+    if (threads < 1)
+        threads = 1;
+
+    const DifficultyBand* band = findBand(difficulty.c_str());
+    if (!band) {
+        std::cerr << "Unknown difficulty: " << difficulty << std::endl;
+        return 1;
+    }
+    if (!makeSolver(solverName)) {
+        std::cerr << "Unknown solver: " << solverName << std::endl;
+        return 1;
+    }
+    FILE* out = outFile.empty() ? stdout : std::fopen(outFile.c_str(), "w");
+    if (!out) {
+        std::cerr << "Failed to write " << outFile << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::mutex outMutex;
+    int written = 0;
+    std::atomic<bool> done(count <= 0);
+    std::atomic<uint64_t> attempts(0);
+    // Attempts finished ahead of nextAttempt; an empty line is a rejected grid
+    std::map<uint64_t, std::string> pending;
+    uint64_t nextAttempt = 0;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            std::unique_ptr<SudokuSolver> solver = makeSolver(solverName);
+            std::mt19937 rng;
+            Grid puzzle;
+            char line[82];
+            line[81] = '\n';
+
+            while (!done) {
+                uint64_t attempt = attempts++;
+                rng.seed(attemptSeed(seed, attempt));
+                randomFullGrid(rng, *solver, puzzle);
+                int clues = removeClues(rng, *solver, puzzle, band->minClues);
+                int guesses = clues > band->maxClues ? -1 : rateGuesses(puzzle);
+                bool accepted = guesses >= band->minGuesses && guesses <= band->maxGuesses;
+                if (accepted)
+                    formatGrid(puzzle, line);
+
+                std::lock_guard<std::mutex> lock(outMutex);
+                pending[attempt] = accepted ? std::string(line, sizeof(line)) : std::string();
+                for (auto it = pending.begin(); it != pending.end() && it->first == nextAttempt && written < count;
+                     it = pending.erase(it), ++nextAttempt) {
+                    if (it->second.empty())
+                        continue;
+                    std::fwrite(it->second.data(), 1, it->second.size(), out);
+                    if (++written == count)
+                        done = true;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    if (out != stdout)
+        std::fclose(out);
+    else
+        std::fflush(out);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << written << ' ' << band->name << " puzzles from " << attempts << " grids in " << seconds << " s ("
+              << written / (seconds > 0 ? seconds : 1e-9) << " puzzles/second, " << threads << " threads)"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "Generator.h"
+#include "Propagate.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const DifficultyBand BANDS[] = {
+    {"easy", 32, 40, 0, 0},
+    {"medium", 26, 31, 0, 0},
+    {"hard", 22, 30, 1, 3},
+    {"expert", 17, 28, 4, 1000},
+};
+
+}
+
+const DifficultyBand* findBand(const char* name) {
+    for (const DifficultyBand& band : BANDS)
+        if (std::strcmp(band.name, name) == 0)
+            return &band;
+    return nullptr;
+}
+
+void randomFullGrid(std::mt19937& rng, SudokuSolver& solver, Grid& grid) {
+    Grid seed;
+    std::memset(&seed, 0, sizeof(seed));
+    for (int box = 0; box < 9; box += 4) {
+        uint8_t digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::shuffle(digits, digits + 9, rng);
+        for (int k = 0; k < 9; ++k)
+            seed.cells[(box / 3 * 3 + k / 3) * 9 + box % 3 * 3 + k % 3] = digits[k];
+    }
+    solver.solve(seed, grid, 1);
+}
+
+int removeClues(std::mt19937& rng, SudokuSolver& solver, Grid& puzzle, int minClues) {
+    uint8_t order[81];
+    int clues = 0;
+    for (int cell = 0; cell < 81; ++cell)
+        if (puzzle.cells[cell])
+            order[clues++] = (uint8_t)cell;
+    std::shuffle(order, order + clues, rng);
+
+    Grid scratch;
+    for (int i = 0, count = clues; i < count && clues > minClues; ++i) {
+        int cell = order[i];
+        uint8_t digit = puzzle.cells[cell];
+        puzzle.cells[cell] = 0;
+        if (solver.solve(puzzle, scratch, 2) == 1)
+            --clues;
+        else
+            puzzle.cells[cell] = digit;
+    }
+    return clues;
+}
+
+int rateGuesses(const Grid& puzzle) {
+    PropagationSolver solver;
+    Grid solution;
+    solver.solve(puzzle, solution, 1);
+    return solver.guesses();
+}
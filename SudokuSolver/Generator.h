@@ -0,0 +1,30 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "SudokuSolver.h"
+#include <random>
+
+// A difficulty class: how many clues a puzzle keeps and how many guesses the
+// propagation solver needs for it (0 means naked and hidden singles suffice)
+struct DifficultyBand {
+    const char* name;
+    int minClues, maxClues;
+    int minGuesses, maxGuesses;
+};
+
+// "easy", "medium", "hard" or "expert"; nullptr for an unknown name
+const DifficultyBand* findBand(const char* name);
+
+// A random solved grid: the three diagonal boxes, which do not constrain each
+// other, get random permutations and the solver completes the rest
+void randomFullGrid(std::mt19937& rng, SudokuSolver& solver, Grid& grid);
+
+// Empties cells of puzzle in random order, keeping each removal only while the
+// puzzle still has exactly one solution, and stops at minClues clues or when
+// no clue can go. Returns the number of clues left.
+int removeClues(std::mt19937& rng, SudokuSolver& solver, Grid& puzzle, int minClues);
+
+// Guesses the propagation solver needs to solve puzzle
+int rateGuesses(const Grid& puzzle);
+
+#endif
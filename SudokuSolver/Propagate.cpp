@@ -0,0 +1,305 @@
+#include "Propagate.h"
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const uint16_t ALL_DIGITS = 0x1FF;
+
+inline bool isSingle(unsigned mask) { return mask && !(mask & (mask - 1)); }
+
+#ifdef __AVX2__
+
+typedef __m256i Vec;
+
+// Digits seen at least once and at least twice over a set of cells. Two counts
+// over disjoint cell sets add up with three ORs and an AND.
+struct Count {
+    Vec once;
+    Vec twice;
+};
+
+inline Count add(Count a, Count b) {
+    return Count{_mm256_or_si256(a.once, b.once),
+                 _mm256_or_si256(_mm256_or_si256(a.twice, b.twice), _mm256_and_si256(a.once, b.once))};
+}
+
+// Moves every lane K lanes towards lane 0 across the whole register, shifting in zeros
+template <int K>
+inline Vec shiftLanes(Vec x) {
+    return _mm256_alignr_epi8(_mm256_permute2x128_si256(x, x, 0x81), x, 2 * K);
+}
+
+template <int K>
+inline Count shifted(Count c) {
+    return Count{shiftLanes<K>(c.once), shiftLanes<K>(c.twice)};
+}
+
+// Totals of one row, in every lane
+inline Count rowTotal(Count c) {
+    c = add(c, shifted<1>(c));
+    c = add(c, shifted<2>(c));
+    c = add(c, shifted<4>(c));
+    c = add(c, shifted<8>(c));
+    return Count{_mm256_broadcastw_epi16(_mm256_castsi256_si128(c.once)),
+                 _mm256_broadcastw_epi16(_mm256_castsi256_si128(c.twice))};
+}
+
+// Totals of lanes 0-2, 3-5 and 6-8, each copied to its three lanes; lanes 9-15 become 0
+inline Vec spreadGroups(Vec x) {
+    const Vec spread = _mm256_setr_epi8(0, 1, 0, 1, 0, 1, 6, 7, 6, 7, 6, 7, 12, 13, 12, 13,
+                                        12, 13, -128, -128, -128, -128, -128, -128, -128, -128,
+                                        -128, -128, -128, -128, -128, -128);
+    return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm256_castsi256_si128(x)), spread);
+}
+
+inline Count boxTotals(Count c) {
+    c = add(add(c, shifted<1>(c)), shifted<2>(c));
+    return Count{spreadGroups(c.once), spreadGroups(c.twice)};
+}
+
+inline bool any(Vec x) { return !_mm256_testz_si256(x, x); }
+
+// All ones in the lanes of decided cells (and only in lanes 0-8)
+inline Vec singles(Vec v, Vec zero, Vec cellLanes) {
+    Vec lowBitCleared = _mm256_and_si256(v, _mm256_sub_epi16(v, _mm256_set1_epi16(1)));
+    Vec oneBit = _mm256_andnot_si256(_mm256_cmpeq_epi16(v, zero), _mm256_cmpeq_epi16(lowBitCleared, zero));
+    return _mm256_and_si256(oneBit, cellLanes);
+}
+
+PropagateResult propagateVector(Candidates& candidates) {
+    const Vec zero = _mm256_setzero_si256();
+    const Vec cellLanes = _mm256_setr_epi16(-1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0);
+    const Vec allDigits = _mm256_and_si256(_mm256_set1_epi16(ALL_DIGITS), cellLanes);
+
+    Vec v[9];
+    for (int r = 0; r < 9; ++r)
+        v[r] = _mm256_load_si256((const Vec*)candidates.rows[r]);
+
+    for (;;) {
+        Vec before[9];
+        Vec decided[9];   // the masks of decided cells, 0 elsewhere
+        bool allDecided = true;
+        Count column = {zero, zero};
+        Count band[3] = {{zero, zero}, {zero, zero}, {zero, zero}};
+        for (int r = 0; r < 9; ++r) {
+            before[r] = v[r];
+            Vec single = singles(v[r], zero, cellLanes);
+            allDecided = allDecided && !any(_mm256_xor_si256(single, cellLanes));
+            decided[r] = _mm256_and_si256(v[r], single);
+            Count c = {decided[r], zero};
+            column = add(column, c);
+            band[r / 3] = add(band[r / 3], c);
+        }
+
+        // Naked singles: a decided digit is removed from every other cell of its units
+        Vec conflicts = column.twice;
+        Count box[3];
+        for (int b = 0; b < 3; ++b) {
+            box[b] = boxTotals(band[b]);
+            conflicts = _mm256_or_si256(conflicts, box[b].twice);
+        }
+        for (int r = 0; r < 9; ++r) {
+            Count row = rowTotal(Count{decided[r], zero});
+            conflicts = _mm256_or_si256(conflicts, row.twice);
+            Vec taken = _mm256_or_si256(_mm256_or_si256(row.once, column.once), box[r / 3].once);
+            v[r] = _mm256_or_si256(_mm256_andnot_si256(taken, v[r]), decided[r]);
+            conflicts = _mm256_or_si256(conflicts, _mm256_and_si256(_mm256_cmpeq_epi16(v[r], zero), cellLanes));
+        }
+        if (any(conflicts))
+            return PROPAGATE_CONTRADICTION;
+
+        // Hidden singles: digits with exactly one place left in a unit
+        column = Count{zero, zero};
+        for (int b = 0; b < 3; ++b)
+            band[b] = Count{zero, zero};
+        for (int r = 0; r < 9; ++r) {
+            Count c = {v[r], zero};
+            column = add(column, c);
+            band[r / 3] = add(band[r / 3], c);
+        }
+        Vec missing = _mm256_xor_si256(column.once, allDigits);
+        Vec columnExact = _mm256_andnot_si256(column.twice, column.once);
+        Vec boxExact[3];
+        for (int b = 0; b < 3; ++b) {
+            box[b] = boxTotals(band[b]);
+            missing = _mm256_or_si256(missing, _mm256_xor_si256(box[b].once, allDigits));
+            boxExact[b] = _mm256_andnot_si256(box[b].twice, box[b].once);
+        }
+        for (int r = 0; r < 9; ++r) {
+            Count row = rowTotal(Count{v[r], zero});
+            missing = _mm256_or_si256(missing, _mm256_xor_si256(_mm256_and_si256(row.once, cellLanes), allDigits));
+            Vec exact = _mm256_andnot_si256(row.twice, row.once);
+            Vec hidden = _mm256_and_si256(v[r], _mm256_or_si256(_mm256_or_si256(exact, columnExact), boxExact[r / 3]));
+            // A cell that is the only place for two digits cannot hold both
+            conflicts = _mm256_or_si256(conflicts, _mm256_andnot_si256(
+                _mm256_cmpeq_epi16(_mm256_and_si256(hidden, _mm256_sub_epi16(hidden, _mm256_set1_epi16(1))), zero),
+                cellLanes));
+            Vec none = _mm256_cmpeq_epi16(hidden, zero);
+            v[r] = _mm256_or_si256(_mm256_and_si256(none, v[r]), _mm256_andnot_si256(none, hidden));
+        }
+        if (any(conflicts) || any(missing))
+            return PROPAGATE_CONTRADICTION;
+
+        bool changed = false;
+        for (int r = 0; r < 9; ++r)
+            changed = changed || any(_mm256_xor_si256(before[r], v[r]));
+        if (!changed) {
+            for (int r = 0; r < 9; ++r)
+                _mm256_store_si256((Vec*)candidates.rows[r], v[r]);
+            return allDecided ? PROPAGATE_SOLVED : PROPAGATE_STUCK;
+        }
+    }
+}
+
+#else
+
+// Cell k of unit u: units 0-8 are rows, 9-17 columns, 18-26 boxes
+inline uint16_t& unitCell(Candidates& candidates, int unit, int k) {
+    if (unit < 9)
+        return candidates.rows[unit][k];
+    if (unit < 18)
+        return candidates.rows[k][unit - 9];
+    int box = unit - 18;
+    return candidates.rows[box / 3 * 3 + k / 3][box % 3 * 3 + k % 3];
+}
+
+PropagateResult propagateScalar(Candidates& candidates) {
+    uint16_t decided[27];
+    uint16_t exact[27];
+    for (;;) {
+        bool changed = false;
+        bool allDecided = true;
+
+        // Naked singles
+        for (int unit = 0; unit < 27; ++unit) {
+            unsigned once = 0, twice = 0;
+            for (int k = 0; k < 9; ++k) {
+                unsigned mask = unitCell(candidates, unit, k);
+                if (isSingle(mask)) {
+                    twice |= once & mask;
+                    once |= mask;
+                }
+            }
+            if (twice)
+                return PROPAGATE_CONTRADICTION;
+            decided[unit] = (uint16_t)once;
+        }
+        for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c) {
+                uint16_t& mask = candidates.rows[r][c];
+                if (isSingle(mask))
+                    continue;
+                allDecided = false;
+                uint16_t reduced = mask & ~(decided[r] | decided[9 + c] | decided[18 + r / 3 * 3 + c / 3]);
+                if (!reduced)
+                    return PROPAGATE_CONTRADICTION;
+                changed = changed || reduced != mask;
+                mask = reduced;
+            }
+        }
+
+        // Hidden singles
+        for (int unit = 0; unit < 27; ++unit) {
+            unsigned once = 0, twice = 0;
+            for (int k = 0; k < 9; ++k) {
+                unsigned mask = unitCell(candidates, unit, k);
+                twice |= once & mask;
+                once |= mask;
+            }
+            if (once != ALL_DIGITS)
+                return PROPAGATE_CONTRADICTION;
+            exact[unit] = (uint16_t)(once & ~twice);
+        }
+        for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c) {
+                uint16_t& mask = candidates.rows[r][c];
+                uint16_t hidden = mask & (exact[r] | exact[9 + c] | exact[18 + r / 3 * 3 + c / 3]);
+                if (!hidden)
+                    continue;
+                if (!isSingle(hidden))
+                    return PROPAGATE_CONTRADICTION;
+                changed = changed || hidden != mask;
+                mask = hidden;
+            }
+        }
+
+        if (!changed)
+            return allDecided ? PROPAGATE_SOLVED : PROPAGATE_STUCK;
+    }
+}
+
+#endif
+
+}
+
+void initCandidates(const Grid& puzzle, Candidates& candidates) {
+    std::memset(&candidates, 0, sizeof(candidates));
+    for (int cell = 0; cell < 81; ++cell) {
+        int digit = puzzle.cells[cell];
+        candidates.rows[cellRow(cell)][cellCol(cell)] = digit ? (uint16_t)(1 << (digit - 1)) : ALL_DIGITS;
+    }
+}
+
+void candidatesToGrid(const Candidates& candidates, Grid& grid) {
+    for (int cell = 0; cell < 81; ++cell) {
+        unsigned mask = candidates.rows[cellRow(cell)][cellCol(cell)];
+        grid.cells[cell] = isSingle(mask) ? (uint8_t)(__builtin_ctz(mask) + 1) : 0;
+    }
+}
+
+PropagateResult propagate(Candidates& candidates) {
+#ifdef __AVX2__
+    return propagateVector(candidates);
+#else
+    return propagateScalar(candidates);
+#endif
+}
+
+int PropagationSolver::solve(const Grid& puzzle, Grid& result, int maxSolutions) {
+    found = 0;
+    limit = maxSolutions > 0 ? maxSolutions : 1;
+    guessCount = 0;
+    solution = &result;
+
+    Candidates candidates;
+    initCandidates(puzzle, candidates);
+    search(candidates);
+    return found;
+}
+
+void PropagationSolver::search(Candidates& candidates) {
+    PropagateResult state = propagate(candidates);
+    if (state == PROPAGATE_CONTRADICTION)
+        return;
+    if (state == PROPAGATE_SOLVED) {
+        if (found++ == 0)
+            candidatesToGrid(candidates, *solution);
+        return;
+    }
+
+    int bestRow = 0, bestCol = 0, bestCount = 10;
+    for (int r = 0; r < 9 && bestCount > 2; ++r) {
+        for (int c = 0; c < 9; ++c) {
+            int count = __builtin_popcount(candidates.rows[r][c]);
+            if (count > 1 && count < bestCount) {
+                bestCount = count;
+                bestRow = r;
+                bestCol = c;
+            }
+        }
+    }
+
+    unsigned options = candidates.rows[bestRow][bestCol];
+    ++guessCount;
+    while (options && found < limit) {
+        unsigned bit = options & (0u - options);
+        options ^= bit;
+        Candidates guess = candidates;
+        guess.rows[bestRow][bestCol] = (uint16_t)bit;
+        search(guess);
+    }
+}
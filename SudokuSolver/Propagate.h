@@ -0,0 +1,49 @@
+#ifndef PROPAGATE_H
+#define PROPAGATE_H
+
+#include "SudokuSolver.h"
+
+// Candidate digits of every cell as 9-bit masks. Each row takes 16 lanes of
+// 16 bits, one AVX2 register, with lanes 9-15 kept at zero. A cell is decided
+// once its mask has a single bit.
+struct alignas(32) Candidates {
+    uint16_t rows[9][16];
+};
+
+enum PropagateResult { PROPAGATE_STUCK, PROPAGATE_SOLVED, PROPAGATE_CONTRADICTION };
+
+// Clues get their own digit, empty cells all nine
+void initCandidates(const Grid& puzzle, Candidates& candidates);
+// Decided cells back to digits; undecided cells become 0
+void candidatesToGrid(const Candidates& candidates, Grid& grid);
+
+// Applies naked singles (a decided digit leaves its row, column and box) and
+// hidden singles (a digit with one place left in a unit goes there) until
+// neither changes anything. Each unit is reduced to "digits seen once" and
+// "digits seen twice or more" masks with ORs and ANDs: across the row registers
+// for columns, across lanes for rows, and both for boxes. Built with -mavx2 the
+// whole grid is processed nine registers at a time; otherwise the same
+// reductions run per cell. Returns CONTRADICTION as soon as a cell has no
+// candidate, a digit is decided twice in a unit or a unit has no room for a digit.
+PropagateResult propagate(Candidates& candidates);
+
+// Propagation, then a guess on the cell with the fewest candidates and
+// propagation again, recursively. Puzzles that propagation alone solves
+// never branch.
+class PropagationSolver : public SudokuSolver {
+public:
+    int solve(const Grid& puzzle, Grid& solution, int limit = 1) override;
+    const char* name() const override { return "propagate"; }
+    // Cells guessed during the last solve; 0 means singles alone solved it
+    int guesses() const { return guessCount; }
+
+private:
+    int found;
+    int limit;
+    int guessCount;
+    Grid* solution;
+
+    void search(Candidates& candidates);
+};
+
+#endif
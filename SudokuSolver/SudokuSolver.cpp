@@ -0,0 +1,34 @@
+#include "SudokuSolver.h"
+#include "BitmaskSolver.h"
+#include "DlxSolver.h"
+#include "Propagate.h"
+
+bool parseGrid(const char* text, size_t length, Grid& grid) {
+    if (length < 81)
+        return false;
+    for (int cell = 0; cell < 81; ++cell) {
+        char c = text[cell];
+        if (c == '.' || c == '0')
+            grid.cells[cell] = 0;
+        else if (c >= '1' && c <= '9')
+            grid.cells[cell] = (uint8_t)(c - '0');
+        else
+            return false;
+    }
+    return true;
+}
+
+void formatGrid(const Grid& grid, char* out) {
+    for (int cell = 0; cell < 81; ++cell)
+        out[cell] = grid.cells[cell] ? (char)('0' + grid.cells[cell]) : '.';
+}
+
+std::unique_ptr<SudokuSolver> makeSolver(const std::string& name) {
+    if (name == "bitmask")
+        return std::unique_ptr<SudokuSolver>(new BitmaskSolver);
+    if (name == "dlx")
+        return std::unique_ptr<SudokuSolver>(new DlxSolver);
+    if (name == "propagate")
+        return std::unique_ptr<SudokuSolver>(new PropagationSolver);
+    return nullptr;
+}
@@ -0,0 +1,41 @@
+#ifndef SUDOKU_SOLVER_H
+#define SUDOKU_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 81 cells in row order, 1-9 for a digit and 0 for an empty cell. Same layout
+// as the board[9][9] of the raylib game, flattened.
+struct Grid {
+    uint8_t cells[81];
+};
+
+inline int cellRow(int cell) { return cell / 9; }
+inline int cellCol(int cell) { return cell % 9; }
+inline int cellBox(int cell) { return cell / 27 * 3 + cell % 9 / 3; }
+
+// Reads the first 81 characters of text: digits, with '0' or '.' for empty.
+// Returns false for a short line or any other character.
+bool parseGrid(const char* text, size_t length, Grid& grid);
+// Writes 81 characters, '.' for empty cells; out is not terminated
+void formatGrid(const Grid& grid, char* out);
+
+// A solving backend. Backends hold their working state as members, so one
+// instance must not be shared between threads; create one per thread instead.
+class SudokuSolver {
+public:
+    virtual ~SudokuSolver() {}
+
+    // Searches puzzle for solutions and stops after limit of them. Returns how
+    // many were found (0 if the puzzle has none or contradicts itself); the
+    // first is written to solution. A limit of 2 answers "is it unique?".
+    virtual int solve(const Grid& puzzle, Grid& solution, int limit = 1) = 0;
+    virtual const char* name() const = 0;
+};
+
+// "bitmask", "dlx" or "propagate"; nullptr for an unknown name
+std::unique_ptr<SudokuSolver> makeSolver(const std::string& name);
+
+#endif